@@ -115,6 +115,8 @@ void CSS_SetCustomCode(bool bIs24Bit, uint16_t Code, bool bIsNarrow)
 {
 	uint16_t Gain = 0x8000;
 
+	BK4819_TRACE_TAG(BK4819_TAG_CSS);
+
 	if (bIsNarrow) {
 		Gain |= gFrequencyBandInfo.DcsTxGainNarrow;
 	} else {
@@ -134,6 +136,8 @@ void CSS_SetStandardCode(uint8_t CodeType, uint16_t Code, uint8_t Encrypt, bool
 	uint16_t Enable;
 	uint32_t Golay;
 
+	BK4819_TRACE_TAG(BK4819_TAG_CSS);
+
 	switch (CodeType) {
 	case CODE_TYPE_CTCSS:
 		if (bNarrow) {
@@ -27,6 +27,7 @@
 #include "helper/inputbox.h"
 #include "misc.h"
 #include "radio/hardware.h"
+#include "radio/scheduler.h"
 #include "radio/settings.h"
 #include "task/cursor.h"
 #include "task/keyaction.h"
@@ -167,7 +168,7 @@ static void DrawMenu(uint8_t Index)
 
 static void EnableTextEditor(void)
 {
-	gCursorCountdown = 500;
+	SCHEDULER_StartTimer(TIMER_CURSOR, 500);
 	gCursorEnabled = true;
 	gCursorBlink = true;
 	gCursorPosition = 0;
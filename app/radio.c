@@ -40,6 +40,9 @@
 #endif
 #include "task/ptt.h"
 #include "task/am-fix.h"
+#ifdef ENABLE_CLOSE_CALL
+	#include "task/closecall.h"
+#endif
 #include "task/scanner.h"
 #include "task/screen.h"
 #include "ui/boot.h"
@@ -158,20 +161,110 @@ static bool TuneTX(bool bUseMic)
 	}
 }
 
+typedef struct {
+	uint16_t Frequency;
+	uint8_t Duration;
+} RogerStep_t;
+
+static const RogerStep_t RogerBeep1[] = {
+	{ 1000, 25 },
+	{    0, 25 },
+	{ 1000, 25 },
+	{    0, 25 },
+	{ 1000, 25 },
+};
+
+static const RogerStep_t RogerBeep2[] = {
+	{ 590, 60 },
+	{ 660, 60 },
+	{ 730, 60 },
+};
+
+static const RogerStep_t *pRogerStep;
+static uint8_t RogerSteps;
+static bool bEndingTX;
+
+static void FinishTX(void)
+{
+	BK4819_TRACE_TAG(BK4819_TAG_TX);
+
+	bEndingTX = false;
+	BK4819_GenTail(gMainVfo->bIsNarrow);
+	gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_RED);
+	BK4819_SetupPowerAmplifier(0);
+	TuneCurrentVfo();
+	UI_DrawSomething();
+	SCHEDULER_StartTimer(TIMER_BATTERY, 3000);
+	SCHEDULER_StartTimer(TIMER_IDLE, 10000);
+}
+
+// Each tone is queued from the task loop, so the other tasks keep running
+// while the beep plays and the TX ends once the last one is done.
+static void NextRogerStep(void)
+{
+	BK4819_TRACE_TAG(BK4819_TAG_TX);
+
+	if (RogerSteps == 0) {
+		BEEP_Disable();
+		FinishTX();
+		return;
+	}
+	BK4819_SetToneFrequency(false, pRogerStep->Frequency);
+	if (!SCHEDULER_After(pRogerStep->Duration, NextRogerStep)) {
+		// The slot is taken, end the TX rather than leave the PA keyed.
+		BEEP_Disable();
+		FinishTX();
+		return;
+	}
+	pRogerStep++;
+	RogerSteps--;
+}
+
+static void PlayRogerBeep(uint8_t Mode)
+{
+	BEEP_Enable();
+
+	if (Mode == 1) {
+		pRogerStep = RogerBeep1;
+		RogerSteps = ARRAY_SIZE(RogerBeep1);
+	} else {
+		pRogerStep = RogerBeep2;
+		RogerSteps = ARRAY_SIZE(RogerBeep2);
+	}
+	NextRogerStep();
+	SPEAKER_TurnOn(SPEAKER_OWNER_SYSTEM);
+}
+
+bool RADIO_IsEndingTX(void)
+{
+	return bEndingTX;
+}
+
+void RADIO_StopRogerBeep(void)
+{
+	if (!bEndingTX) {
+		return;
+	}
+	SCHEDULER_CancelAfter();
+	BEEP_Disable();
+	FinishTX();
+}
+
 static void SpecialRxTxLoop(void)
 {
 	static bool bFlag;
 
 	while (1) {
 		while (1) {
-			while (gSpecialTimer) {
+			while (SCHEDULER_IsTimerRunning(TIMER_SPECIAL)) {
 			}
-			gSpecialTimer = 30000;
+			SCHEDULER_StartTimer(TIMER_SPECIAL, 30000);
 			if (!bFlag) {
 				break;
 			}
 			bFlag = false;
 			RADIO_EndTX();
+			RADIO_StopRogerBeep();
 			RADIO_StartRX();
 		}
 		bFlag = true;
@@ -259,6 +352,8 @@ void RADIO_Init(void)
 
 void RADIO_Tune(uint8_t Vfo)
 {
+	BK4819_TRACE_TAG(BK4819_TAG_TUNE);
+
 	gMainVfo = &gVfoState[Vfo];
 	if (Vfo != 2) {
 		gNoaaMode = false;
@@ -271,6 +366,8 @@ void RADIO_Tune(uint8_t Vfo)
 
 void RADIO_StartRX(void)
 {
+	BK4819_TRACE_TAG(BK4819_TAG_RX);
+
 #ifdef ENABLE_FM_RADIO
 	FM_Disable(FM_MODE_STANDBY);
 #endif
@@ -278,11 +375,11 @@ void RADIO_StartRX(void)
 	if (!gFrequencyDetectMode) {
 		DTMF_ClearString();
 		DTMF_FSK_InitReceive(0);
-		VOX_Timer = 0;
+		SCHEDULER_StopTimer(TIMER_VOX);
 		Task_UpdateScreen();
 		SCREEN_TurnOn();
 		if (gScannerMode && gExtendedSettings.ScanResume == 2) {	// Time Operated
-			SCANNER_Countdown = 5000;
+			SCHEDULER_StartTimer(TIMER_SCANNER, 5000);
 		}
 		if (gScreenMode == SCREEN_MAIN && !gDTMF_InputMode) {
 			if (gSettings.DualDisplay == 0 && gSettings.CurrentVfo != gCurrentVfo) {
@@ -309,6 +406,8 @@ void RADIO_StartRX(void)
 
 void RADIO_EndRX(void)
 {
+	BK4819_TRACE_TAG(BK4819_TAG_RX);
+
 	gTailToneCounter = 0;
 	BK4819_SetAF(BK4819_AF_MUTE);
 	SPEAKER_TurnOff(SPEAKER_OWNER_RX);
@@ -318,7 +417,7 @@ void RADIO_EndRX(void)
 	if (gScannerMode) {
 		switch (gExtendedSettings.ScanResume) {
 			case 1:		// Carrier Operated
-				SCANNER_Countdown = 3000;
+				SCHEDULER_StartTimer(TIMER_SCANNER, 3000);
 			case 2:		// Time Operated
 				gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_GREEN);
 				break;
@@ -333,7 +432,7 @@ void RADIO_EndRX(void)
 			if (!gFskDataReceived && !gDataDisplay) {
 				UI_DrawSomething();
 			} else {
-				VOX_Timer = 5000;
+				SCHEDULER_StartTimer(TIMER_VOX, 5000);
 				gRedrawScreen = true;
 			}
 		} else {
@@ -348,7 +447,7 @@ void RADIO_EndRX(void)
 		}
 		gRxLinkCounter = 0;
 		gNoToneCounter = 0;
-		gIdleTimer = 10000;
+		SCHEDULER_StartTimer(TIMER_IDLE, 10000);
 		PTT_ClearLock(PTT_LOCK_INCOMING);
 		PTT_ClearLock(PTT_LOCK_BUSY);
 #ifdef ENABLE_FM_RADIO
@@ -356,10 +455,10 @@ void RADIO_EndRX(void)
 			FM_Resume();
 		}
 #endif
-		gIncomingTimer = 1;
+		SCHEDULER_StartTimer(TIMER_INCOMING, 1);
 	} else {
 		gSignalFound = true;
-		gDetectorTimer = 500;
+		SCHEDULER_StartTimer(TIMER_DETECTOR, 500);
 	}
 }
 
@@ -378,9 +477,9 @@ void RADIO_EndAudio(void)
 	SPEAKER_TurnOff(SPEAKER_OWNER_RX);
 	gRxLinkCounter = 0;
 	gNoToneCounter = 0;
-	gIncomingTimer = 1;
+	SCHEDULER_StartTimer(TIMER_INCOMING, 1);
 #ifdef ENABLE_NOAA
-	NOAA_NextChannelCountdown = 3000;
+	SCHEDULER_StartTimer(TIMER_NOAA, 3000);
 #endif
 }
 
@@ -388,38 +487,25 @@ void RADIO_Sleep(void)
 {
 	EnableTxAmp(false);
 	BK4819_EnableFilter(false);
-	BK4819_WriteRegister(0x30, 0x0000);
-	BK4819_WriteRegister(0x37, 0x1D00);
+	BK4819_RunProgram(BK4819_PROGRAM_SLEEP);
 	gSaveMode = true;
 }
 
-static void PlayRogerBeep(uint8_t Mode)
+// Moves the receiver of the current VFO without going through the full tune
+// path. Band dependent settings are reloaded only when an edge is crossed.
+void RADIO_FastTune(uint32_t Frequency)
 {
-	BEEP_Enable();
+	BK4819_TRACE_TAG(BK4819_TAG_TUNE);
 
-	if (Mode == 1) {
-		BK4819_SetToneFrequency(false, 1000);
-		SPEAKER_TurnOn(SPEAKER_OWNER_SYSTEM);
-		DELAY_WaitMS(25);
-		BK4819_SetToneFrequency(false, 0);
-		DELAY_WaitMS(25);
-		BK4819_SetToneFrequency(false, 1000);
-		DELAY_WaitMS(25);
-		BK4819_SetToneFrequency(false, 0);
-		DELAY_WaitMS(25);
-		BK4819_SetToneFrequency(false, 1000);
-		DELAY_WaitMS(25);
-	} else {
-		BK4819_SetToneFrequency(false, 590);
-		SPEAKER_TurnOn(SPEAKER_OWNER_SYSTEM);
-		DELAY_WaitMS(60);
-		BK4819_SetToneFrequency(false, 660);
-		DELAY_WaitMS(60);
-		BK4819_SetToneFrequency(false, 730);
-		DELAY_WaitMS(60);
-	}
+	gRadioMode = RADIO_MODE_QUIET;
+	if (FREQUENCY_SelectBand(Frequency)) {
+		BK4819_TRACE_TAG(BK4819_TAG_BAND);
 
-	BEEP_Disable();
+		BK4819_SetSquelchNoise(gMainVfo->bIsNarrow);
+		BK4819_SetSquelchRSSI(gMainVfo->bIsNarrow);
+		BK4819_EnableFilter(true);
+	}
+	BK4819_TuneFrequency(Frequency);
 }
 
 void RADIO_Retune(void)
@@ -452,7 +538,7 @@ void RADIO_NoaaTune(void)
 	UI_DrawNOAA(gNOAA_ChannelNow);
 	CHANNELS_SetNoaaChannel(gNOAA_ChannelNow);
 	RADIO_Tune(2);
-	NOAA_NextChannelCountdown = 3000;
+	SCHEDULER_StartTimer(TIMER_NOAA, 3000);
 	gNoaaMode = false;
 }
 #endif
@@ -485,6 +571,12 @@ void RADIO_SaveCurrentVfo(void)
 
 void RADIO_StartTX(bool bUseMic)
 {
+	BK4819_TRACE_TAG(BK4819_TAG_TX);
+
+	RADIO_StopRogerBeep();
+#ifdef ENABLE_CLOSE_CALL
+	CLOSECALL_Cancel();
+#endif
 	if (gRadioMode == RADIO_MODE_RX) {
 		RADIO_EndRX();
 	}
@@ -497,7 +589,7 @@ void RADIO_StartTX(bool bUseMic)
 		}
 	} else {
 		gpio_bits_set(GPIOA, BOARD_GPIOA_LED_RED);
-		VOX_Timer = 0;
+		SCHEDULER_StopTimer(TIMER_VOX);
 		if (gDTMF_InputMode) {
 			UI_DrawMain(true);
 		}
@@ -531,6 +623,10 @@ void RADIO_StartTX(bool bUseMic)
 
 void RADIO_EndTX(void)
 {
+	// The roger beep is still playing and ends the TX by itself.
+	if (bEndingTX) {
+		return;
+	}
 	if (gDTMF_Settings.Mode == DTMF_MODE_TX_END || gDTMF_Settings.Mode == DTMF_MODE_TX_START_END) {
 		DTMF_PlayContact(&gDTMF_Contacts[gDTMF_Settings.Select]);
 	}
@@ -541,15 +637,11 @@ void RADIO_EndTX(void)
 	// 	BK4819_ResetFSK();
 	// } else
 	if (gSettings.RogerBeep && gSettings.RogerBeep != 3) {
+		bEndingTX = true;
 		PlayRogerBeep(gSettings.RogerBeep);
+		return;
 	}
-	BK4819_GenTail(gMainVfo->bIsNarrow);
-	gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_RED);
-	BK4819_SetupPowerAmplifier(0);
-	TuneCurrentVfo();
-	UI_DrawSomething();
-	gBatteryTimer = 3000;
-	gIdleTimer = 10000;
+	FinishTX();
 }
 
 void RADIO_CancelMode(void)
@@ -563,11 +655,12 @@ void RADIO_CancelMode(void)
 	}
 	if (gRadioMode == RADIO_MODE_TX) {
 		RADIO_EndTX();
+		RADIO_StopRogerBeep();
 	} else if (gRadioMode == RADIO_MODE_RX) {
 		gMonitorMode = false;
 		RADIO_EndRX();
 	}
-	VOX_Timer = 0;
+	SCHEDULER_StopTimer(TIMER_VOX);
 	Task_UpdateScreen();
 }
 
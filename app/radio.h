@@ -31,6 +31,7 @@ extern uint16_t gCode;
 
 void RADIO_Init(void);
 void RADIO_Tune(uint8_t Vfo);
+void RADIO_FastTune(uint32_t Frequency);
 
 void RADIO_StartRX(void);
 void RADIO_EndRX(void);
@@ -50,6 +51,12 @@ void RADIO_SaveCurrentVfo(void);
 
 void RADIO_StartTX(bool bFlag);
 void RADIO_EndTX(void);
+// True while the roger beep plays: the PA is still keyed and gRadioMode is
+// still RADIO_MODE_TX, but the TX is on its way out.
+bool RADIO_IsEndingTX(void);
+// Cuts a roger beep short for callers that need the TX over right away,
+// such as anything that stops the task loop running the deferred slot.
+void RADIO_StopRogerBeep(void);
 
 void RADIO_CancelMode(void);
 void RADIO_DisableSaveMode(void);
@@ -0,0 +1,225 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <stdbool.h>
+#include <string.h>
+#include "app/recorder.h"
+#include "driver/serial-flash.h"
+#include "driver/uart.h"
+#include "radio/scheduler.h"
+
+// Pages 0x3E2 to 0x3FF are past everything the PC tools write.
+#define RECORDER_FIRST_PAGE	0x3E2U
+#define RECORDER_PAGES		30U
+#define RECORDER_ROWS_PER_PAGE	(4096U / sizeof(RecorderRow_t))
+#define RECORDER_ROWS		(RECORDER_PAGES * RECORDER_ROWS_PER_PAGE)
+
+// Bytes handed to the TX queue per pass, well under its 127 free bytes.
+#define EXPORT_CHUNK		32U
+
+_Static_assert(sizeof(RecorderRow_t) == 128, "Rows must tile the flash pages");
+
+static RecorderRow_t Row;
+static uint16_t Head;
+static uint32_t NextSequence;
+static bool bFoundHead;
+
+static uint8_t Frame[sizeof(RecorderRow_t) + 2];
+static uint8_t FrameOffset;
+static uint8_t FrameLength;
+static uint16_t ExportAge;
+static uint16_t ExportCount;
+static volatile bool bExportRequested;
+static bool bExporting;
+
+static uint32_t GetAddress(uint16_t Index)
+{
+	return (RECORDER_FIRST_PAGE * 4096U) + (Index * sizeof(RecorderRow_t));
+}
+
+// The newest page is the one whose first row has the highest sequence,
+// the head is the first empty row after it.
+static void FindHead(void)
+{
+	uint32_t Sequence;
+	uint32_t Newest = 0xFFFFFFFFU;
+	uint16_t Page = 0;
+	uint16_t i;
+
+	bFoundHead = true;
+
+	for (i = 0; i < RECORDER_PAGES; i++) {
+		SFLASH_Read(&Sequence, GetAddress(i * RECORDER_ROWS_PER_PAGE), sizeof(Sequence));
+		if (Sequence != 0xFFFFFFFFU && (Newest == 0xFFFFFFFFU || Sequence > Newest)) {
+			Newest = Sequence;
+			Page = i;
+		}
+	}
+
+	if (Newest == 0xFFFFFFFFU) {
+		Head = 0;
+		NextSequence = 0;
+		return;
+	}
+
+	Head = Page * RECORDER_ROWS_PER_PAGE;
+	NextSequence = Newest;
+	for (i = 0; i < RECORDER_ROWS_PER_PAGE; i++) {
+		SFLASH_Read(&Sequence, GetAddress(Head), sizeof(Sequence));
+		if (Sequence == 0xFFFFFFFFU) {
+			break;
+		}
+		NextSequence = Sequence + 1;
+		Head = (Head + 1) % RECORDER_ROWS;
+	}
+}
+
+void RECORDER_AppendRow(const uint16_t *pRssi, uint8_t Columns, uint16_t Low, uint16_t High, uint32_t FreqMin, uint32_t FreqStep)
+{
+	uint16_t Level;
+	uint8_t i;
+
+	// Rows appended now would shift the ring under the export.
+	if (RECORDER_IsExporting()) {
+		return;
+	}
+
+	if (!bFoundHead) {
+		FindHead();
+	}
+
+	memset(&Row, 0xFF, sizeof(Row));
+	Row.Sequence = NextSequence++;
+	Row.Time = gTimeSinceBoot;
+	Row.FreqMin = FreqMin;
+	Row.FreqStep = FreqStep;
+	Row.Low = Low;
+	Row.High = High;
+	Row.Columns = Columns;
+
+	for (i = 0; i < Columns && i < sizeof(Row.Levels) * 2; i++) {
+		Level = 0;
+		if (pRssi[i] > Low) {
+			Level = ((pRssi[i] - Low) * 15) / (High - Low);
+			if (Level > 15) {
+				Level = 15;
+			}
+		}
+		if (i & 1) {
+			Row.Levels[i / 2] = (Row.Levels[i / 2] & 0x0F) | (Level << 4);
+		} else {
+			Row.Levels[i / 2] = (Row.Levels[i / 2] & 0xF0) | Level;
+		}
+	}
+
+	// Erasing ahead drops the oldest page once the ring has wrapped.
+	if ((Head % RECORDER_ROWS_PER_PAGE) == 0) {
+		SFLASH_Erase(RECORDER_FIRST_PAGE + (Head / RECORDER_ROWS_PER_PAGE));
+	}
+	SFLASH_Write(&Row, GetAddress(Head), sizeof(Row));
+	Head = (Head + 1) % RECORDER_ROWS;
+}
+
+uint16_t RECORDER_GetCount(void)
+{
+	uint16_t Kept;
+
+	if (!bFoundHead) {
+		FindHead();
+	}
+
+	Kept = ((RECORDER_PAGES - 1) * RECORDER_ROWS_PER_PAGE) + (Head % RECORDER_ROWS_PER_PAGE);
+
+	if (NextSequence < Kept) {
+		return NextSequence;
+	}
+
+	return Kept;
+}
+
+const RecorderRow_t *RECORDER_ReadRow(uint16_t Age)
+{
+	if (!bFoundHead) {
+		FindHead();
+	}
+
+	SFLASH_Read(&Row, GetAddress((Head + RECORDER_ROWS - 1 - Age) % RECORDER_ROWS), sizeof(Row));
+
+	return &Row;
+}
+
+uint8_t RECORDER_GetLevel(const RecorderRow_t *pRow, uint8_t Column)
+{
+	if (Column & 1) {
+		return pRow->Levels[Column / 2] >> 4;
+	}
+
+	return pRow->Levels[Column / 2] & 0x0F;
+}
+
+void RECORDER_RequestExport(void)
+{
+	bExportRequested = true;
+}
+
+bool RECORDER_IsExporting(void)
+{
+	return bExportRequested || bExporting;
+}
+
+// Sends every row oldest first as 0x57, the row and a checksum, then 0x06,
+// the row count and a checksum. Frames go out through the TX queue a chunk
+// at a time so the loop keeps running while the rows drain.
+void RECORDER_ContinueExport(void)
+{
+	uint8_t Size;
+
+	if (bExportRequested) {
+		bExportRequested = false;
+		bExporting = true;
+		ExportCount = RECORDER_GetCount();
+		ExportAge = ExportCount;
+		FrameOffset = 0;
+		FrameLength = 0;
+	}
+
+	if (!bExporting) {
+		return;
+	}
+
+	if (FrameOffset == FrameLength) {
+		if (FrameLength && Frame[0] == 0x06) {
+			bExporting = false;
+			return;
+		}
+		if (ExportAge) {
+			SFLASH_Read(&Row, GetAddress((Head + RECORDER_ROWS - ExportAge) % RECORDER_ROWS), sizeof(Row));
+			FrameLength = UART_BuildFrame(Frame, 0x57, &Row, sizeof(Row));
+			ExportAge--;
+		} else {
+			FrameLength = UART_BuildFrame(Frame, 0x06, &ExportCount, sizeof(ExportCount));
+		}
+		FrameOffset = 0;
+	}
+
+	Size = FrameLength - FrameOffset;
+	if (Size > EXPORT_CHUNK) {
+		Size = EXPORT_CHUNK;
+	}
+	if (UART_Queue(Frame + FrameOffset, Size)) {
+		FrameOffset += Size;
+	}
+}
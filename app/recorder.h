@@ -0,0 +1,47 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef APP_RECORDER_H
+#define APP_RECORDER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// One spectrum sweep as stored in serial flash, 32 rows per 4 kB page.
+typedef struct __attribute__((packed)) {
+	uint32_t Sequence;	// Rows written since the region was erased, 0xFFFFFFFF = empty
+	uint32_t Time;		// gTimeSinceBoot at the end of the sweep
+	uint32_t FreqMin;
+	uint32_t FreqStep;
+	uint16_t Low;		// RSSI of level 0
+	uint16_t High;		// RSSI of level 15
+	uint8_t Columns;
+	uint8_t Levels[80];	// 4 bits per column, even columns in the low nibble
+	uint8_t Padding[27];
+} RecorderRow_t;
+
+void RECORDER_AppendRow(const uint16_t *pRssi, uint8_t Columns, uint16_t Low, uint16_t High, uint32_t FreqMin, uint32_t FreqStep);
+uint16_t RECORDER_GetCount(void);
+// Age 0 is the newest row.
+const RecorderRow_t *RECORDER_ReadRow(uint16_t Age);
+uint8_t RECORDER_GetLevel(const RecorderRow_t *pRow, uint8_t Column);
+// Safe from the UART interrupt, the rows go out from RECORDER_ContinueExport.
+void RECORDER_RequestExport(void);
+bool RECORDER_IsExporting(void);
+void RECORDER_ContinueExport(void);
+
+#endif
+
@@ -17,8 +17,10 @@
 #include "misc.h"
 #include "app/spectrum.h"
 #include "app/radio.h"
+#ifdef ENABLE_SPECTRUM_RECORDER
+#include "app/recorder.h"
+#endif
 #include "driver/bk4819.h"
-#include "driver/delay.h"
 #include "driver/key.h"
 #include "driver/pins.h"
 #include "driver/speaker.h"
@@ -26,10 +28,14 @@
 #include "helper/helper.h"
 #include "helper/inputbox.h"
 #include "radio/channels.h"
+#include "radio/scheduler.h"
 #include "radio/settings.h"
 #include "ui/gfx.h"
 #include "ui/helper.h"
 #include "ui/main.h"
+#ifdef ENABLE_CLOSE_CALL
+#include "task/closecall.h"
+#endif
 #include "../misc.h"
 
 #ifdef UART_DEBUG
@@ -44,6 +50,45 @@
 #define SCROLL_LEFT_MARGIN 55
 #define SCROLL_RIGHT_MARGIN 160
 
+enum {
+	TRACE_OFF,
+	TRACE_AVERAGE,
+	TRACE_PEAK,
+	TRACE_MIN,
+	TRACE_COUNT,
+};
+
+enum {
+	POOL_MAX,
+	POOL_MEAN,
+};
+
+#define SEGMENT_COUNT 4
+
+// Noise floor: the 25th percentile of a sweep in 2 dB buckets, followed
+// with a time constant of 8 sweeps.
+#define NOISE_BUCKETS 128
+#define NOISE_PERCENTILE 25
+#define NOISE_SHIFT 3
+
+// Coarse to fine: a quick pass reads one bin per column, then the columns
+// around the strongest peaks over the squelch are read again bin by bin.
+#define REFINE_PEAKS 4
+#define REFINE_COARSE_DELAY 1
+#define REFINE_FINE_DELAY 3
+
+enum {
+	PASS_FULL,
+	PASS_COARSE,
+	PASS_FINE,
+};
+
+typedef struct {
+	uint32_t FreqMin;
+	uint32_t FreqStep;
+	uint16_t StepCount;
+} Segment_t;
+
 static uint32_t CurrentFreq;
 static uint8_t CurrentFreqIndex;
 static uint32_t FreqCenter;
@@ -54,18 +99,59 @@ static uint8_t CurrentFreqStepIndex;
 static uint32_t CurrentFreqStep;
 static uint32_t CurrentFreqChangeStep;
 static uint8_t CurrentStepCountIndex;
-static uint8_t CurrentStepCount;
+static uint16_t CurrentStepCount;
+static uint8_t ColumnCount;
+static uint8_t BinsPerColumn;
 static uint16_t CurrentScanDelay;
 static uint16_t RssiValue[160] = {0};
-static uint16_t SquelchLevel;
 static uint8_t bExit;
 static uint8_t bRXMode;
-static uint8_t bResetSquelch;
+static uint8_t bResetFloor;
 static uint8_t bRestartScan;
 static uint8_t bFilterEnabled;
 static uint8_t bNarrow;
-static uint16_t RssiLow;
-static uint16_t RssiHigh;
+// Per segment, only the first entry is used outside of multi-segment mode.
+// The noise floor is kept in 1/16 RSSI steps.
+static uint16_t NoiseFloor[SEGMENT_COUNT];
+static uint16_t SquelchLevel[SEGMENT_COUNT];
+static uint8_t SquelchMargin;
+static uint16_t RssiHigh[SEGMENT_COUNT];
+static uint16_t ScaleLow[SEGMENT_COUNT];
+static uint16_t ScaleHigh[SEGMENT_COUNT];
+static Segment_t Segments[SEGMENT_COUNT];
+static uint8_t SegmentCount;
+static uint8_t bMultiSegment;
+static uint8_t SweepSegment;
+static uint8_t SweepColumn;
+static uint8_t SegmentEnd;
+static uint32_t SweepFreq;
+static uint32_t SweepStep;
+static uint8_t SweepPass;
+static uint8_t PassBins;
+static uint8_t bSweepDone;
+static uint8_t bRefine;
+static uint8_t RefineColumn[REFINE_PEAKS];
+static uint8_t RefineCount;
+static uint8_t RefineIndex;
+static uint8_t PoolMode;
+static uint8_t PoolCount;
+static uint16_t PoolSum;
+static uint16_t PoolMax;
+static uint32_t PoolPeakFreq;
+static uint8_t WaterfallRow;
+// Average in 1/16 RSSI steps, peak and min hold in 1 dB steps.
+static uint16_t TraceAvg[160];
+static uint8_t TracePeak[160];
+static uint8_t TraceMin[160];
+static uint8_t TraceMode;
+static uint8_t TraceShift;
+static uint8_t bResetTraces;
+#ifdef ENABLE_SPECTRUM_RECORDER
+static uint8_t bRecord;
+static uint8_t bReplay;
+// Rows still to replay, the next one is ReplayAge - 1 sweeps old.
+static uint16_t ReplayAge;
+#endif
 static uint8_t bHold;
 #ifdef ENABLE_SPECTRUM_PRESETS
 FreqPreset CurrentBandInfo;
@@ -83,6 +169,34 @@ void ShiftShortStringRight(uint8_t Start, uint8_t End) {
 	}
 }
 
+uint8_t GetSegmentCount(void) {
+	return (bMultiSegment) ? SegmentCount : 1;
+}
+
+uint8_t GetSegment(uint8_t Column) {
+	if (!bMultiSegment) {
+		return 0;
+	}
+
+	return Column / (ColumnCount / SegmentCount);
+}
+
+// Each tile pools as many bins as keeps it close to the span the segment
+// was added with.
+uint8_t GetSegmentBins(uint8_t Segment) {
+	uint8_t Width;
+	uint8_t Bins;
+
+	if (!bMultiSegment) {
+		return BinsPerColumn;
+	}
+
+	Width = ColumnCount / SegmentCount;
+	Bins = (Segments[Segment].StepCount + (Width / 2)) / Width;
+
+	return (Bins) ? Bins : 1;
+}
+
 void DrawCurrentFreq(uint16_t Color) {
 
 	gColorForeground = Color;
@@ -109,7 +223,7 @@ void DrawCurrentFreq(uint16_t Color) {
 	}
 	
 	gColorForeground = COLOR_RED;
-	ConvertRssiToDbm(SquelchLevel);
+	ConvertRssiToDbm(SquelchLevel[GetSegment(CurrentFreqIndex)]);
 	if (!DisplayMode) {
 		UI_DrawSmallString(118, 60, gShortString, 4);
 	} else {
@@ -136,16 +250,30 @@ void GetCurrentBand(void) {
 }
 #endif
 
+// M and the segment count while the segments are swept, the count alone otherwise.
+void DrawSegmentLabel(uint8_t X, uint8_t Y) {
+	gShortString[0] = (bMultiSegment) ? 'M' : ' ';
+	gShortString[1] = (SegmentCount) ? '0' + SegmentCount : ' ';
+	UI_DrawSmallString(X, Y, gShortString, 2);
+}
+
 void DrawLabels(void) {
+	uint32_t Low = FreqMin;
+	uint32_t High = FreqMax;
+
+	if (bMultiSegment) {
+		Low = Segments[0].FreqMin;
+		High = Segments[SegmentCount - 1].FreqMin + (Segments[SegmentCount - 1].FreqStep * Segments[SegmentCount - 1].StepCount);
+	}
 
 	gColorForeground = COLOR_FOREGROUND;
 
-	Int2Ascii(FreqMin / 10, 7);
+	Int2Ascii(Low / 10, 7);
 	ShiftShortStringRight(2, 7);
 	gShortString[3] = '.';
 	UI_DrawSmallString(2, 2, gShortString, 8);
 
-	Int2Ascii(FreqMax / 10, 7);
+	Int2Ascii(High / 10, 7);
 	ShiftShortStringRight(2, 7);
 	gShortString[3] = '.';
 	if (!DisplayMode) {
@@ -162,8 +290,9 @@ void DrawLabels(void) {
 
 	if (!DisplayMode) {
 		gShortString[2] = ' ';
-		Int2Ascii(CurrentStepCount, (CurrentStepCount < 100) ? 2 : 3);
-		UI_DrawSmallString(2, 72, gShortString, 3);
+		gShortString[3] = ' ';
+		Int2Ascii(CurrentStepCount, (CurrentStepCount < 100) ? 2 : (CurrentStepCount < 1000) ? 3 : 4);
+		UI_DrawSmallString(2, 72, gShortString, 4);
 
 		UI_DrawSmallString(2, 60, StepStrings[CurrentFreqStepIndex], 5);
 	} else {
@@ -184,6 +313,25 @@ void DrawLabels(void) {
 		UI_DrawSmallString(152, 60, (bNarrow) ? "N" : "W", 1);	
 
 		UI_DrawSmallString(2, 14, (bHold) ? "H" : " ", 1);
+		DrawSegmentLabel(18, 14);
+		UI_DrawSmallString(34, 14, (bRefine) ? "C" : " ", 1);
+#ifdef ENABLE_SPECTRUM_RECORDER
+		UI_DrawSmallString(10, 14, (bRecord) ? "R" : " ", 1);
+#endif
+
+		if (TraceMode == TRACE_AVERAGE) {
+			gShortString[0] = 'A';
+			gShortString[1] = '0' + TraceShift;
+			UI_DrawSmallString(64, 60, gShortString, 2);
+		} else {
+			UI_DrawSmallString(64, 60, (TraceMode == TRACE_PEAK) ? "PK" : (TraceMode == TRACE_MIN) ? "MN" : "  ", 2);
+		}
+
+		if (BinsPerColumn > 1) {
+			UI_DrawSmallString(82, 60, (PoolMode == POOL_MEAN) ? "AVG" : "MAX", 3);
+		} else {
+			UI_DrawSmallString(82, 60, "   ", 3);
+		}
 	} else {
 		UI_DrawSmallString(32, 72, gShortString, 2);
 
@@ -192,6 +340,11 @@ void DrawLabels(void) {
 		UI_DrawSmallString(15, 60, (bNarrow) ? "N" : "W", 1);	
 
 		UI_DrawSmallString(30, 60, (bHold) ? "H" : " ", 1);
+		DrawSegmentLabel(20, 50);
+		UI_DrawSmallString(38, 50, (bRefine) ? "C" : " ", 1);
+#ifdef ENABLE_SPECTRUM_RECORDER
+		UI_DrawSmallString(40, 60, (bReplay) ? "P" : (bRecord) ? "R" : " ", 1);
+#endif
 	}
 
 	gColorForeground = COLOR_GREY;
@@ -216,13 +369,34 @@ void SetFreqMinMax(void) {
 	FREQUENCY_SelectBand(FreqCenter);
 	BK4819_EnableFilter(bFilterEnabled);
 	RssiValue[CurrentFreqIndex] = 0; // Force a rescan
+	bRestartScan = TRUE;
+	bResetTraces = TRUE;
+}
+
+// Sweeps may cross a band edge, so the filter follows the band per bin.
+void Tune(uint32_t Frequency) {
+	if (FREQUENCY_SelectBand(Frequency)) {
+		BK4819_EnableFilter(bFilterEnabled);
+	}
+	BK4819_TuneFrequency(Frequency);
 }
 
 void SetStepCount(void) {
-	if (!DisplayMode) {
-		CurrentStepCount = 160 >> CurrentStepCountIndex;	
+	const uint8_t Width = (!DisplayMode) ? 160 : 128;
+
+	if (CurrentStepCountIndex < STEPS_128) {
+		// Sweeps wider than the screen pool several bins into each column.
+		ColumnCount = Width;
+		BinsPerColumn = 1 << (STEPS_128 - CurrentStepCountIndex);
 	} else {
-		CurrentStepCount = 128 >> CurrentStepCountIndex;
+		ColumnCount = Width >> (CurrentStepCountIndex - STEPS_128);
+		BinsPerColumn = 1;
+	}
+	CurrentStepCount = ColumnCount * BinsPerColumn;
+
+	// Segments get equal tiles and pool their bins per tile, see StartSegment().
+	if (bMultiSegment) {
+		ColumnCount = (Width / SegmentCount) * SegmentCount;
 	}
 }
 
@@ -256,20 +430,41 @@ void ChangeCenterFreq(uint8_t Up) {
 }
 
 void ChangeHoldFreq(uint8_t Up) {
+	uint16_t Bin;
+
+	if (bMultiSegment) {
+		return;
+	}
+
+	Bin = (CurrentFreq - FreqMin) / CurrentFreqStep;
 	if (Up) {
-		CurrentFreqIndex = (CurrentFreqIndex + 1) % CurrentStepCount;
+		Bin = (Bin + 1) % CurrentStepCount;
 	} else {
-		CurrentFreqIndex = (CurrentFreqIndex + CurrentStepCount -1) % CurrentStepCount;
+		Bin = (Bin + CurrentStepCount -1) % CurrentStepCount;
 	}
-	CurrentFreq = FreqMin + (CurrentFreqIndex * CurrentFreqStep);
+	CurrentFreqIndex = Bin / BinsPerColumn;
+	CurrentFreq = FreqMin + (Bin * CurrentFreqStep);
 }
 
-void ChangeSquelchLevel(uint8_t Up) {
+void UpdateSquelch(void) {
+	for (uint8_t s = 0; s < GetSegmentCount(); s++) {
+		SquelchLevel[s] = (NoiseFloor[s] >> 4) + SquelchMargin;
+	}
+}
+
+// The squelch follows the noise floor, the keys set how far above it sits.
+void ChangeSquelchMargin(uint8_t Up) {
 	if (Up) {
-		SquelchLevel += 2;
+		if (SquelchMargin < 100) {
+			SquelchMargin += 2;
+		}
 	} else {
-		SquelchLevel -= 2;
+		if (SquelchMargin > 2) {
+			SquelchMargin -= 2;
+		}
 	}
+	UpdateSquelch();
+	DrawCurrentFreq((bRXMode) ? COLOR_GREEN : COLOR_BLUE);
 }
 
 #ifdef ENABLE_SPECTRUM_PRESETS
@@ -300,7 +495,7 @@ void ChangeBandPreset(uint8_t Up) {
 	BK4819_WriteRegister(0x43, (bNarrow) ? 0x4048 : 0x3028);
 
 	bRestartScan = TRUE;
-	bResetSquelch = TRUE;
+	bResetFloor = TRUE;
 
 	DrawCurrentFreq((bRXMode) ? COLOR_GREEN : COLOR_BLUE);
 	DrawLabels();
@@ -310,10 +505,13 @@ void ChangeBandPreset(uint8_t Up) {
 void ChangeDisplayMode(void) {
 	DisplayMode ^= 1;
 	bRestartScan = TRUE;
+#ifdef ENABLE_SPECTRUM_RECORDER
+	bReplay = FALSE;
+#endif
 
 	ST7735S_Init();
 
-	CurrentStepCountIndex = 0;
+	CurrentStepCountIndex = STEPS_128;
 	SetStepCount();
 	SetFreqMinMax();
 	if (DisplayMode) {
@@ -326,8 +524,9 @@ void ChangeDisplayMode(void) {
 void ToggleFilter(void) {
 	bFilterEnabled ^= 1;
 	BK4819_EnableFilter(bFilterEnabled);
-	bResetSquelch = TRUE;
+	bResetFloor = TRUE;
 	bRestartScan = TRUE;
+	bResetTraces = TRUE;
 	DrawLabels();
 }
 
@@ -337,6 +536,120 @@ void ToggleNarrowWide(void) {
 	DrawLabels();
 }
 
+void IncrementTraceMode(void) {
+	TraceMode = (TraceMode + 1) % TRACE_COUNT;
+	DrawLabels();
+}
+
+// Averaging weight of a new sweep is 1/2 to 1/16.
+void IncrementTraceShift(void) {
+	TraceShift = (TraceShift % 4) + 1;
+	DrawLabels();
+}
+
+void UpdateTraces(uint8_t i) {
+	const uint16_t Rssi = RssiValue[i];
+
+	if (bResetTraces) {
+		TraceAvg[i] = Rssi << 4;
+		TracePeak[i] = Rssi >> 1;
+		TraceMin[i] = Rssi >> 1;
+		return;
+	}
+
+	TraceAvg[i] = TraceAvg[i] - (TraceAvg[i] >> TraceShift) + ((Rssi << 4) >> TraceShift);
+
+	// Peaks decay by 1 dB per sweep down to the current level.
+	if ((Rssi >> 1) >= TracePeak[i]) {
+		TracePeak[i] = Rssi >> 1;
+	} else {
+		TracePeak[i]--;
+	}
+
+	if ((Rssi >> 1) < TraceMin[i]) {
+		TraceMin[i] = Rssi >> 1;
+	}
+}
+
+uint16_t GetTraceLevel(uint8_t i) {
+	switch (TraceMode) {
+	case TRACE_AVERAGE:
+		return TraceAvg[i] >> 4;
+	case TRACE_PEAK:
+		return TracePeak[i] << 1;
+	default:
+		return TraceMin[i] << 1;
+	}
+}
+
+void ToggleRefine(void) {
+	bRefine ^= 1;
+	bRestartScan = TRUE;
+	DrawLabels();
+}
+
+void ToggleMultiSegment(void) {
+	if (!bMultiSegment && SegmentCount == 0) {
+		return;
+	}
+
+	bMultiSegment ^= 1;
+#ifdef ENABLE_SPECTRUM_RECORDER
+	// A row only describes one evenly stepped range.
+	if (bMultiSegment) {
+		bRecord = FALSE;
+	}
+#endif
+	SetStepCount();
+	CurrentFreqIndex = 0;
+	bRestartScan = TRUE;
+	bResetTraces = TRUE;
+	bResetFloor = TRUE;
+
+	if (!DisplayMode) {
+		DISPLAY_DrawRectangle1(0, BarY, BarScale + 1, 160, COLOR_BACKGROUND);
+	}
+	DrawLabels();
+}
+
+// Segments are kept in frequency order, so a round over them walks the
+// BK4819 bands upwards and each band table is loaded once per round.
+void AddSegment(void) {
+	uint8_t i;
+
+	if (SegmentCount == SEGMENT_COUNT) {
+		return;
+	}
+
+	for (i = SegmentCount; i > 0 && Segments[i - 1].FreqMin > FreqMin; i--) {
+		Segments[i] = Segments[i - 1];
+	}
+	Segments[i].FreqMin = FreqMin;
+	Segments[i].FreqStep = CurrentFreqStep;
+	Segments[i].StepCount = CurrentStepCount;
+	SegmentCount++;
+
+	if (bMultiSegment) {
+		bMultiSegment = FALSE;
+		ToggleMultiSegment();
+	} else {
+		DrawLabels();
+	}
+}
+
+void ClearSegments(void) {
+	if (bMultiSegment) {
+		ToggleMultiSegment();
+	}
+	SegmentCount = 0;
+	DrawLabels();
+}
+
+void TogglePoolMode(void) {
+	PoolMode ^= 1;
+	DrawLabels();
+}
+
 void IncrementModulation(void) {
 	CurrentModulation = (CurrentModulation + 1) % 3;
 	DrawCurrentFreq((bRXMode) ? COLOR_GREEN : COLOR_BLUE);
@@ -379,42 +692,119 @@ void JumpToVFO(void) {
 	bExit = TRUE;
 }
 
-void DrawSpectrum(uint16_t ActiveBarColor) {
-	uint8_t BarLow;
-	uint8_t BarHigh;
+// A low percentile of the columns, so carriers in the span and single odd
+// bins do not move it the way the minimum and maximum did.
+uint16_t EstimateFloor(uint8_t First, uint8_t Last) {
+	uint8_t Histogram[NOISE_BUCKETS] = {0};
+	uint8_t Target;
+	uint8_t Count;
+	uint8_t i;
+
+	for (i = First; i < Last; i++) {
+		Histogram[(RssiValue[i] >> 2 < NOISE_BUCKETS) ? RssiValue[i] >> 2 : NOISE_BUCKETS - 1]++;
+	}
+
+	Target = ((Last - First) * NOISE_PERCENTILE) / 100;
+	Count = 0;
+	for (i = 0; i < NOISE_BUCKETS - 1; i++) {
+		Count += Histogram[i];
+		if (Count > Target) {
+			break;
+		}
+	}
+
+	return (i << 2) + 2;
+}
+
+void UpdateNoiseFloor(void) {
+	const uint8_t Width = ColumnCount / GetSegmentCount();
+	int32_t Estimate;
+
+	for (uint8_t s = 0; s < GetSegmentCount(); s++) {
+		Estimate = EstimateFloor(s * Width, (s + 1) * Width) << 4;
+		if (bResetFloor) {
+			NoiseFloor[s] = Estimate;
+		} else {
+			NoiseFloor[s] += (Estimate - NoiseFloor[s]) >> NOISE_SHIFT;
+		}
+	}
+	bResetFloor = FALSE;
+
+	UpdateSquelch();
+}
+
+// The scale comes from the last full sweep, so the bars of the sweep in
+// progress are all drawn against the same reference. It sits on the noise
+// floor rather than the weakest column.
+void UpdateScale(void) {
+	uint16_t Floor;
+
+	for (uint8_t s = 0; s < GetSegmentCount(); s++) {
+		Floor = NoiseFloor[s] >> 4;
+		if (!DisplayMode) {
+			ScaleLow[s] = Floor - 2;
+			if (RssiHigh[s] < Floor + 40) {
+				ScaleHigh[s] = Floor + 40;
+			} else {
+				ScaleHigh[s] = RssiHigh[s] + 5;
+			}
+		} else {
+			ScaleLow[s] = Floor;
+			if (RssiHigh[s] < Floor + 60) {
+				ScaleHigh[s] = Floor + 60;
+			} else {
+				ScaleHigh[s] = RssiHigh[s];
+			}
+		}
+	}
+}
+
+void DrawBar(uint8_t i, uint16_t ActiveBarColor) {
 	uint16_t Power;
 	uint16_t SquelchPower;
+	uint16_t Color;
 	uint8_t BarX;
 	uint8_t BarWidth;
+	const uint8_t s = GetSegment(i);
+
+	BarWidth = 160 / ColumnCount;
+	BarX = (i * BarWidth);
+	Power = GetAdjustedLevel(RssiValue[i], ScaleLow[s], ScaleHigh[s], BarScale);
+	SquelchPower = GetAdjustedLevel(SquelchLevel[s], ScaleLow[s], ScaleHigh[s], BarScale);
+	Color = (i == CurrentFreqIndex) ? ActiveBarColor : COLOR_FOREGROUND;
+
+	// The row of the squelch line is left alone so it survives the redraw.
+	if (Power < SquelchPower) {
+		DISPLAY_DrawRectangle1(BarX, BarY, Power, BarWidth, Color);
+		DISPLAY_DrawRectangle1(BarX, BarY + Power, SquelchPower - Power, BarWidth, COLOR_BACKGROUND);
+		DISPLAY_DrawRectangle1(BarX, BarY + SquelchPower + 1, BarScale - SquelchPower, BarWidth, COLOR_BACKGROUND);
+	} else { 
+		DISPLAY_DrawRectangle1(BarX, BarY, SquelchPower, BarWidth, Color);
+		DISPLAY_DrawRectangle1(BarX, BarY + SquelchPower + 1, Power - SquelchPower, BarWidth, Color);
+		DISPLAY_DrawRectangle1(BarX, BarY + Power + 1, BarScale - Power, BarWidth, COLOR_BACKGROUND);
+	} 
 
-	BarLow = RssiLow - 2;
-	if ((RssiHigh - RssiLow) < 40) {
-		BarHigh = RssiLow + 40;
-	} else {
-		BarHigh = RssiHigh + 5;
+	if (TraceMode != TRACE_OFF) {
+		Power = GetAdjustedLevel(GetTraceLevel(i), ScaleLow[s], ScaleHigh[s], BarScale);
+		DISPLAY_DrawRectangle1(BarX, BarY + Power, 1, BarWidth, COLOR_GREEN);
 	}
+}
 
-	BarWidth = 160 / CurrentStepCount;
+void DrawSquelchLine(void) {
+	const uint8_t Width = (ColumnCount / GetSegmentCount()) * (160 / ColumnCount);
+	uint16_t Power;
 
-	//Bars
-	for (uint8_t i = 0; i < CurrentStepCount; i++) {
-		BarX = (i * BarWidth);
-		Power = GetAdjustedLevel(RssiValue[i], BarLow, BarHigh, BarScale);
-		SquelchPower = GetAdjustedLevel(SquelchLevel, BarLow, BarHigh, BarScale);
-		if (Power < SquelchPower) {
-			DISPLAY_DrawRectangle1(BarX, BarY, Power, BarWidth, (i == CurrentFreqIndex) ? ActiveBarColor : COLOR_FOREGROUND);
-			DISPLAY_DrawRectangle1(BarX, BarY + Power, SquelchPower - Power, BarWidth, COLOR_BACKGROUND);
-			DISPLAY_DrawRectangle1(BarX, BarY + SquelchPower + 1, BarScale - SquelchPower, BarWidth, COLOR_BACKGROUND);
-		} else { 
-			DISPLAY_DrawRectangle1(BarX, BarY, SquelchPower, BarWidth, (i == CurrentFreqIndex) ? ActiveBarColor : COLOR_FOREGROUND);
-			DISPLAY_DrawRectangle1(BarX, BarY + SquelchPower + 1, Power - SquelchPower, BarWidth, (i == CurrentFreqIndex) ? ActiveBarColor : COLOR_FOREGROUND);
-			DISPLAY_DrawRectangle1(BarX, BarY + Power + 1, BarScale - Power, BarWidth, COLOR_BACKGROUND);
-		} 
+	for (uint8_t s = 0; s < GetSegmentCount(); s++) {
+		Power = GetAdjustedLevel(SquelchLevel[s], ScaleLow[s], ScaleHigh[s], BarScale);
+		DISPLAY_DrawRectangle1(s * Width, BarY + Power, 1, Width, COLOR_RED);
 	}
+}
 
-	//Squelch Line
-	Power = GetAdjustedLevel(SquelchLevel, BarLow, BarHigh, BarScale);
-	DISPLAY_DrawRectangle1(0, BarY + Power, 1, 160, COLOR_RED);
+void DrawSpectrum(uint16_t ActiveBarColor) {
+	for (uint8_t i = 0; i < ColumnCount; i++) {
+		DrawBar(i, ActiveBarColor);
+	}
+	DrawSquelchLine();
 }
 
 uint16_t MapColor(uint16_t Level){
@@ -451,37 +841,94 @@ uint16_t MapColor(uint16_t Level){
 	return COLOR_RGB(R, G, B);
 }
 
-void DrawWaterfall()
-{
-	static uint8_t scroll;
-	uint16_t High;
+void ScrollWaterfall(void) {
+	WaterfallRow++;
+	WaterfallRow %= (SCROLL_RIGHT_MARGIN - SCROLL_LEFT_MARGIN);
+
+	ST7735S_scroll(WaterfallRow);
+}
+
+void DrawWaterfallBin(uint8_t i) {
+	uint16_t Color;
+	uint8_t Height;
+	uint8_t Y;
 
-	if ((RssiHigh - RssiLow) < 60) {
-		High = RssiLow + 60;
+	Height = 128 / ColumnCount;
+	Y = i * Height;
+	Color = MapColor(GetAdjustedLevel(RssiValue[i], ScaleLow[GetSegment(i)], ScaleHigh[GetSegment(i)], 100));
+
+	ST7735S_SetAddrWindow(SCROLL_RIGHT_MARGIN - WaterfallRow, Y, SCROLL_RIGHT_MARGIN - WaterfallRow, Y + Height - 1);
+	for (uint8_t j = 0; j < Height; j++) {
+		ST7735S_SendU16(Color); // write to screen using waterfall color from palette
+	}
+}
+
+void DrawWaterfallMarker(void) {
+	DISPLAY_DrawRectangle1(52, 0, 128, 3, COLOR_BACKGROUND);
+	DISPLAY_DrawRectangle1(52, CurrentFreqIndex * (128 / ColumnCount), 1, 3, COLOR_FOREGROUND);
+}
+
+#ifdef ENABLE_SPECTRUM_RECORDER
+void ToggleRecord(void) {
+	if (!bRecord && bMultiSegment) {
+		return;
+	}
+	bRecord ^= 1;
+	DrawLabels();
+}
+
+// Replay plays the recorded rows oldest first through the waterfall.
+void ToggleReplay(void) {
+	if (bRXMode) {
+		return;
+	}
+	if (bReplay) {
+		bReplay = FALSE;
+		bRestartScan = TRUE;
 	} else {
-		High = RssiHigh;
+		if (!DisplayMode) {
+			ChangeDisplayMode();
+		}
+		bReplay = TRUE;
+		ReplayAge = RECORDER_GetCount();
 	}
+	DrawLabels();
+}
 
-	scroll++;
-	scroll %= (SCROLL_RIGHT_MARGIN - SCROLL_LEFT_MARGIN);
+void ChangeReplayAge(uint8_t Up) {
+	const uint16_t Count = RECORDER_GetCount();
 
-	ST7735S_scroll(scroll);
+	if (Up) {
+		ReplayAge = (ReplayAge + 100 < Count) ? ReplayAge + 100 : Count;
+	} else {
+		ReplayAge = (ReplayAge > 100) ? ReplayAge - 100 : 0;
+	}
+}
 
-	ST7735S_SetAddrWindow((SCROLL_RIGHT_MARGIN)-scroll, 0, (SCROLL_RIGHT_MARGIN)-scroll, 127);
+void ContinueReplay(void) {
+	const RecorderRow_t *pRow;
+	uint8_t Columns;
 
-	for (uint8_t i = 0; i < 127; i++)
-	{		
-		uint16_t wf = GetAdjustedLevel(RssiValue[i], RssiLow, High, 100);
-		wf = MapColor(wf);
+	SCHEDULER_StartTimer(TIMER_SPECTRUM, 20);
+	if (ReplayAge == 0) {
+		return;
+	}
 
-		//uint16_t wf = MapColor(RssiValue[i] - RssiLow);
+	pRow = RECORDER_ReadRow(--ReplayAge);
+	Columns = (pRow->Columns > 160) ? 160 : pRow->Columns;
 
-		ST7735S_SendU16(wf); // write to screen using waterfall color from palette
+	ScrollWaterfall();
+	ST7735S_SetAddrWindow(SCROLL_RIGHT_MARGIN - WaterfallRow, 0, SCROLL_RIGHT_MARGIN - WaterfallRow, 127);
+	for (uint8_t y = 0; y < 128; y++) {
+		ST7735S_SendU16(MapColor((RECORDER_GetLevel(pRow, (y * Columns) / 128) * 100) / 15));
 	}
 
-	DISPLAY_DrawRectangle1(52, 0, 128, 3, COLOR_BACKGROUND);
-	DISPLAY_DrawRectangle1(52, CurrentFreqIndex, 1, 3, COLOR_FOREGROUND);
+	// Seconds since boot of the session that recorded the row.
+	gColorForeground = COLOR_FOREGROUND;
+	Int2Ascii(pRow->Time / 1000, 8);
+	UI_DrawSmallString(2, 20, gShortString, 8);
 }
+#endif
 
 void StopSpectrum(void) {
 
@@ -496,6 +943,7 @@ void StopSpectrum(void) {
 		CHANNELS_LoadChannel(gSettings.CurrentVfo ? 1000 : 999, gSettings.CurrentVfo);
 	}
 
+	gScreenMode = SCREEN_MAIN;
 	RADIO_Tune(gSettings.CurrentVfo);
 	UI_DrawMain(false);
 }
@@ -504,6 +952,12 @@ void StopSpectrum(void) {
 
 static inline void KEY_UP_fn()
 {
+#ifdef ENABLE_SPECTRUM_RECORDER
+	if (bReplay) {
+		ChangeReplayAge(TRUE);
+		return;
+	}
+#endif
 	if (bHold) {
 		ChangeHoldFreq(TRUE);
 	} else {
@@ -513,6 +967,12 @@ static inline void KEY_UP_fn()
 
 static inline void KEY_DOWN_fn()
 {
+#ifdef ENABLE_SPECTRUM_RECORDER
+	if (bReplay) {
+		ChangeReplayAge(FALSE);
+		return;
+	}
+#endif
 	if (bHold) {
 		ChangeHoldFreq(FALSE);
 	} else {
@@ -541,13 +1001,13 @@ static inline void ChangeBandPreset_DOWN()
 	ChangeBandPreset(FALSE);
 }
 
-static inline void ChangeSquelchLevel_UP()
+static inline void ChangeSquelchMargin_UP()
 {
-	ChangeBandPreset(TRUE);
+	ChangeSquelchMargin(TRUE);
 }
-static inline void ChangeSquelchLevel_DOWN()
+static inline void ChangeSquelchMargin_DOWN()
 {
-	ChangeBandPreset(FALSE);
+	ChangeSquelchMargin(FALSE);
 }
 
 void (*check_key_fn[])(void) ={
@@ -557,10 +1017,10 @@ void (*check_key_fn[])(void) ={
 	[KEY_3] = &IncrementModulation,
 	[KEY_4] = &IncrementFreqStepIndex,
 	[KEY_5] = &ChangeBandPreset_DOWN,
-	[KEY_6] = &ChangeSquelchLevel_UP,
+	[KEY_6] = &ChangeSquelchMargin_UP,
 	[KEY_7] = &KEY_7_fn,
 	[KEY_8] = &ChangeDisplayMode,
-	[KEY_9] = &ChangeSquelchLevel_DOWN,
+	[KEY_9] = &ChangeSquelchMargin_DOWN,
 	[KEY_MENU] = &JumpToVFO,
 	[KEY_UP] = &KEY_UP_fn,
 	[KEY_DOWN] = &KEY_DOWN_fn,
@@ -570,6 +1030,32 @@ void (*check_key_fn[])(void) ={
 	[KEY_NONE] = &FUNCTION_NOP,
 };
 
+// Second functions, used while side key 1 is held.
+void (*check_key_function_fn[])(void) ={
+	[KEY_0] = &FUNCTION_NOP,
+	[KEY_1] = &IncrementTraceMode,
+	[KEY_2] = &IncrementTraceShift,
+	[KEY_3] = &TogglePoolMode,
+#ifdef ENABLE_SPECTRUM_RECORDER
+	[KEY_4] = &ToggleRecord,
+	[KEY_5] = &ToggleReplay,
+#else
+	[KEY_4] = &FUNCTION_NOP,
+	[KEY_5] = &FUNCTION_NOP,
+#endif
+	[KEY_6] = &AddSegment,
+	[KEY_7] = &ToggleMultiSegment,
+	[KEY_8] = &ToggleRefine,
+	[KEY_9] = &ClearSegments,
+	[KEY_MENU] = &FUNCTION_NOP,
+	[KEY_UP] = &FUNCTION_NOP,
+	[KEY_DOWN] = &FUNCTION_NOP,
+	[KEY_EXIT] = &FUNCTION_NOP,
+	[KEY_STAR] = &FUNCTION_NOP,
+	[KEY_HASH] = &FUNCTION_NOP,
+	[KEY_NONE] = &FUNCTION_NOP,
+};
+
 void CheckKeys(void) {
 	static uint8_t KeyHoldTimer;
 	static KEY_t Key;
@@ -585,8 +1071,18 @@ void CheckKeys(void) {
 	}
 	if (Key != LastKey || KeyHoldTimer >= 50) {
 		KeyHoldTimer = 0;
-		check_key_fn[Key]();
 		LastKey = Key;
+		// Keys keep the display on, the first one after it timed out only wakes it.
+		if (Key != KEY_NONE && gEnableBlink) {
+			SCREEN_TurnOn();
+			return;
+		}
+		STANDBY_Counter = 0;
+		if (!gpio_input_data_bit_read(GPIOF, BOARD_GPIOF_KEY_SIDE1)) {
+			check_key_function_fn[Key]();
+		} else {
+			check_key_fn[Key]();
+		}
 	}
 }
 
@@ -596,129 +1092,347 @@ void Spectrum_StartAudio(void) {
 	gpio_bits_set(GPIOA, BOARD_GPIOA_LED_GREEN);
 	gRadioMode = RADIO_MODE_RX;
 	OpenAudio(bNarrow, CurrentModulation);
-	if (CurrentModulation == 0) {
-		BK4819_WriteRegister(0x4D, 0xA080);
-		BK4819_WriteRegister(0x4E, 0x6F7C);
-	}
-
 	if (CurrentModulation > 0) {
 		// AM, SSB
 		BK4819_EnableScramble(false);
 		BK4819_EnableCompander(false);
-		// Set bit 4 of register 73 (Auto Frequency Control Disable)
-		uint16_t reg_73 = BK4819_ReadRegister(0x73);
-		BK4819_WriteRegister(0x73, reg_73 | 0x10U);
-		if (CurrentModulation > 1) { // if SSB
-			BK4819_WriteRegister(0x43, 0b0010000001011000); // Filter 6.25KHz
-			BK4819_WriteRegister(0x37, 0b0001011000001111);
-			BK4819_WriteRegister(0x3D, 0b0010101101000101);
-			BK4819_WriteRegister(0x48, 0b0000001110101000);
-		}
+		BK4819_RunProgram(CurrentModulation > 1 ? BK4819_PROGRAM_SSB_AUDIO : BK4819_PROGRAM_AM_AUDIO);
 	} else {
 		// FM
+		BK4819_RunProgram(BK4819_PROGRAM_FM_AUDIO);
 		BK4819_EnableScramble(false);
 		BK4819_EnableCompander(true);
-		uint16_t reg_73 = BK4819_ReadRegister(0x73);
-		BK4819_WriteRegister(0x73, reg_73 & ~0x10U);
 		BK4819_SetAFResponseCoefficients(false, true, gCalibration.RX_3000Hz_Coefficient);
 	}
 	SPEAKER_TurnOn(SPEAKER_OWNER_RX);
 }
 
-void RunRX(void) {
-	bRXMode = TRUE;
-	Spectrum_StartAudio();
+// Bins settle on TIMER_SPECTRUM, which runs while the previous bin is
+// being drawn and the keys are checked.
+void StartSettle(void) {
+	uint16_t Delay = CurrentScanDelay;
 
-	while(RssiValue[CurrentFreqIndex] > SquelchLevel) {
-		RssiValue[CurrentFreqIndex] = BK4819_GetRSSI();
-		CheckKeys();
-		if (bExit){
-			RADIO_EndAudio();
-			return;
-		}
-		DrawCurrentFreq(COLOR_GREEN);
-		if (!DisplayMode){
-			DrawSpectrum(COLOR_GREEN);
-		}
-		DELAY_WaitMS(5);
+	if (PassBins < BinsPerColumn && Delay > REFINE_COARSE_DELAY) {
+		Delay = REFINE_COARSE_DELAY;
+	} else if (SweepPass == PASS_FINE && Delay < REFINE_FINE_DELAY) {
+		// The fine pass is only worth it if it reads better than the coarse one.
+		Delay = REFINE_FINE_DELAY;
+	}
+	if (Delay) {
+		SCHEDULER_StartTimer(TIMER_SPECTRUM, Delay + 1);
 	}
+}
 
-	RADIO_EndAudio();
-	bRXMode = FALSE;
+void StartSegment(uint8_t Segment) {
+	SweepSegment = Segment;
+
+	if (!bMultiSegment) {
+		SweepFreq = FreqMin;
+		SweepStep = CurrentFreqStep;
+		SegmentEnd = ColumnCount;
+	} else {
+		SweepFreq = Segments[Segment].FreqMin;
+		SweepStep = Segments[Segment].FreqStep;
+		BinsPerColumn = GetSegmentBins(Segment);
+		SegmentEnd = (Segment + 1) * (ColumnCount / SegmentCount);
+	}
+
+	// The coarse pass reads the middle bin of each column only, columns of
+	// a single bin are read in full.
+	PassBins = BinsPerColumn;
+	if (SweepPass == PASS_COARSE && BinsPerColumn > 1) {
+		SweepFreq += SweepStep * (BinsPerColumn / 2);
+		SweepStep *= BinsPerColumn;
+		PassBins = 1;
+	}
 }
 
-void Spectrum_Loop(void) {
-	uint32_t FreqToCheck;
-	CurrentFreqIndex = 0;
-	CurrentFreq = FreqMin;
-	bResetSquelch = TRUE;
-	bRestartScan = FALSE;
+// Columns Column - 1 to Column + 1 within the segment, bin by bin.
+void StartWindow(uint8_t Column) {
+	uint8_t First;
 
-	//UI_DrawStatusIcon(139, ICON_BATTERY, true, COLOR_FOREGROUND);
-	//UI_DrawBattery(false);
+	StartSegment(GetSegment(Column));
 
-	DrawLabels();
+	First = SegmentEnd - (ColumnCount / GetSegmentCount());
+	if (Column > First) {
+		SweepFreq += (SweepStep * BinsPerColumn) * (Column - 1 - First);
+		First = Column - 1;
+	}
+	SweepColumn = First;
+	if (SegmentEnd > Column + 2) {
+		SegmentEnd = Column + 2;
+	}
+}
 
-	while (1) {
-		FreqToCheck = FreqMin;
-		bRestartScan = TRUE;
+// Moves on to the next bin, FALSE once the pass is complete.
+bool NextBin(void) {
+	if (PoolCount == 0 && SweepColumn >= SegmentEnd) {
+		if (SweepPass == PASS_FINE) {
+			if (++RefineIndex >= RefineCount) {
+				return FALSE;
+			}
+			StartWindow(RefineColumn[RefineIndex]);
+			return TRUE;
+		}
+		if (SweepColumn >= ColumnCount) {
+			return FALSE;
+		}
+		StartSegment(SweepSegment + 1);
+	} else {
+		SweepFreq += SweepStep;
+	}
 
-		for (uint8_t i = 0; i < CurrentStepCount; i++) {
+	return TRUE;
+}
 
-			if (bRestartScan) {
-				bRestartScan = FALSE;
-				RssiLow = 330;
-				RssiHigh = 72;
-				i = 0;
+// Local maxima over the squelch, the strongest REFINE_PEAKS of them kept in
+// column order so the fine pass still walks the bands upwards.
+void FindRefinePeaks(void) {
+	uint8_t Weakest;
+
+	RefineCount = 0;
+	for (uint8_t i = 0; i < ColumnCount; i++) {
+		// Columns of a single bin were already read in full.
+		if (RssiValue[i] <= SquelchLevel[GetSegment(i)] || GetSegmentBins(GetSegment(i)) == 1) {
+			continue;
+		}
+		if ((i > 0 && RssiValue[i - 1] >= RssiValue[i]) || (i + 1 < ColumnCount && RssiValue[i + 1] > RssiValue[i])) {
+			continue;
+		}
+		if (RefineCount == REFINE_PEAKS) {
+			Weakest = 0;
+			for (uint8_t j = 1; j < REFINE_PEAKS; j++) {
+				if (RssiValue[RefineColumn[j]] < RssiValue[RefineColumn[Weakest]]) {
+					Weakest = j;
+				}
+			}
+			if (RssiValue[RefineColumn[Weakest]] >= RssiValue[i]) {
+				continue;
 			}
+			for (uint8_t j = Weakest; j < REFINE_PEAKS - 1; j++) {
+				RefineColumn[j] = RefineColumn[j + 1];
+			}
+			RefineCount--;
+		}
+		RefineColumn[RefineCount++] = i;
+	}
+}
 
-			BK4819_set_rf_frequency(FreqToCheck, TRUE);
+void StartSweep(void) {
+	SweepColumn = 0;
+	PoolCount = 0;
+	PoolSum = 0;
+	bSweepDone = FALSE;
+	SweepPass = (bRefine) ? PASS_COARSE : PASS_FULL;
+	for (uint8_t s = 0; s < GetSegmentCount(); s++) {
+		RssiHigh[s] = 72;
+	}
+	StartSegment(0);
 
-			DELAY_WaitMS(CurrentScanDelay);
+	if (DisplayMode) {
+		ScrollWaterfall();
+	}
 
-			RssiValue[i] = BK4819_GetRSSI();
+	Tune(SweepFreq);
+	StartSettle();
+}
 
-			if (RssiValue[i] < RssiLow) {
-				RssiLow = RssiValue[i];
-			} else if (RssiValue[i] > RssiHigh) {
-				RssiHigh = RssiValue[i];
-			}
+// Bins are pooled into their display column as they arrive, so sweeps
+// wider than the screen need no full resolution buffer. Returns TRUE once
+// the column is complete.
+bool MeasureBin(void) {
+	const uint16_t Rssi = BK4819_GetRSSI();
+	uint8_t i;
+	uint8_t Previous;
+
+	if (PoolCount == 0 || Rssi > PoolMax) {
+		PoolMax = Rssi;
+		PoolPeakFreq = SweepFreq;
+	}
+	PoolSum += Rssi;
+	if (++PoolCount < PassBins) {
+		return FALSE;
+	}
 
-			if (RssiValue[i] > RssiValue[CurrentFreqIndex] && !bHold) {
-				CurrentFreqIndex = i;
-				CurrentFreq = FreqToCheck;
-			}
+	i = SweepColumn++;
+	RssiValue[i] = (PoolMode == POOL_MEAN) ? PoolSum / PoolCount : PoolMax;
+	PoolCount = 0;
+	PoolSum = 0;
 
-			FreqToCheck += CurrentFreqStep;
+	if (SweepPass != PASS_FINE) {
+		UpdateTraces(i);
+	}
 
-			CheckKeys();
-			if (bExit){
-				return;
-			}
-		}
+	if (RssiValue[i] > RssiHigh[SweepSegment]) {
+		RssiHigh[SweepSegment] = RssiValue[i];
+	}
 
-		if (bResetSquelch) {
-			bResetSquelch = FALSE;
-			SquelchLevel = RssiHigh + 5;
+	// The peak still resolves to the strongest bin inside the column, a fine
+	// pass over the peak column moves it to the bin it actually sits on.
+	if ((RssiValue[i] > RssiValue[CurrentFreqIndex] || (SweepPass == PASS_FINE && i == CurrentFreqIndex)) && !bHold) {
+		Previous = CurrentFreqIndex;
+		CurrentFreqIndex = i;
+		CurrentFreq = PoolPeakFreq;
+		// Bars behind the sweep keep their colour until the next pass.
+		if (!DisplayMode && Previous < i) {
+			DrawBar(Previous, COLOR_BLUE);
 		}
+	}
 
-		if (RssiValue[CurrentFreqIndex] > SquelchLevel) {
-			BK4819_set_rf_frequency(CurrentFreq, TRUE);
-			DELAY_WaitMS(CurrentScanDelay);
-			RunRX();
-		}
+	return TRUE;
+}
 
-		DrawCurrentFreq(COLOR_BLUE);
+// Holds on the peak with audio open until it drops under the squelch.
+void ContinueRX(void) {
+	if (!gReceivingAudio) {
+		Spectrum_StartAudio();
+	}
 
+	RssiValue[CurrentFreqIndex] = BK4819_GetRSSI();
+	if (RssiValue[CurrentFreqIndex] <= SquelchLevel[GetSegment(CurrentFreqIndex)]) {
+		RADIO_EndAudio();
+		bRXMode = FALSE;
+		bRestartScan = TRUE;
+		DrawCurrentFreq(COLOR_BLUE);
 		if (!DisplayMode) {
 			DrawSpectrum(COLOR_BLUE);
 		} else {
-			DrawWaterfall();
+			DrawWaterfallMarker();
 		}
+		return;
+	}
+
+	DrawCurrentFreq(COLOR_GREEN);
+	if (!DisplayMode) {
+		DrawSpectrum(COLOR_GREEN);
+	}
+	SCHEDULER_StartTimer(TIMER_SPECTRUM, 5 + 1);
+}
+
+// Returns TRUE if a fine pass was started in place of ending the sweep.
+bool StartFinePass(void) {
+	FindRefinePeaks();
+	if (RefineCount == 0) {
+		return FALSE;
+	}
+
+	SweepPass = PASS_FINE;
+	RefineIndex = 0;
+	bSweepDone = FALSE;
+	StartWindow(RefineColumn[0]);
+	Tune(SweepFreq);
+	StartSettle();
+
+	return TRUE;
+}
+
+void EndSweep(void) {
+	// The floor and squelch come from the full span, before the fine pass
+	// reads the peaks again.
+	if (SweepPass != PASS_FINE) {
+		UpdateNoiseFloor();
+	}
+	if (SweepPass == PASS_COARSE && StartFinePass()) {
+		return;
 	}
+
+	bResetTraces = FALSE;
+	UpdateScale();
+
+#ifdef ENABLE_SPECTRUM_RECORDER
+	if (bRecord) {
+		RECORDER_AppendRow(RssiValue, ColumnCount, ScaleLow[0], ScaleHigh[0], FreqMin, CurrentFreqStep * BinsPerColumn);
+	}
+#endif
+
+	if (RssiValue[CurrentFreqIndex] > SquelchLevel[GetSegment(CurrentFreqIndex)]) {
+		Tune(CurrentFreq);
+		StartSettle();
+		bRXMode = TRUE;
+		return;
+	}
+
+	DrawCurrentFreq(COLOR_BLUE);
+
+	if (!DisplayMode) {
+		DrawSquelchLine();
+	} else {
+		DrawWaterfallMarker();
+	}
+
+	bRestartScan = TRUE;
+}
+
+bool SPECTRUM_Step(void) {
+	uint8_t Index;
+	bool bColumnDone;
+
+	if (!bRXMode && bRestartScan
+#ifdef ENABLE_SPECTRUM_RECORDER
+			&& !bReplay
+#endif
+			) {
+		bRestartScan = FALSE;
+		StartSweep();
+	}
+
+	if (SCHEDULER_IsTimerRunning(TIMER_SPECTRUM)) {
+		return FALSE;
+	}
+
+#ifdef ENABLE_SPECTRUM_RECORDER
+	if (bReplay) {
+		ContinueReplay();
+	} else
+#endif
+	if (bRXMode) {
+		ContinueRX();
+	} else {
+		// Retune before drawing, so bin N+1 settles while bin N is rendered.
+		Index = SweepColumn;
+		bColumnDone = MeasureBin();
+		if (NextBin()) {
+			Tune(SweepFreq);
+			StartSettle();
+		} else {
+			bSweepDone = TRUE;
+		}
+
+		if (bColumnDone) {
+			if (!DisplayMode) {
+				DrawBar(Index, COLOR_BLUE);
+			} else {
+				DrawWaterfallBin(Index);
+			}
+		}
+	}
+
+	CheckKeys();
+	if (bExit) {
+		if (bRXMode) {
+			RADIO_EndAudio();
+		}
+		StopSpectrum();
+		return FALSE;
+	}
+
+#ifdef ENABLE_SPECTRUM_RECORDER
+	if (bReplay) {
+		return FALSE;
+	}
+#endif
+
+	if (!bRXMode && !bRestartScan && bSweepDone) {
+		EndSweep();
+	}
+
+	return !bRXMode;
 }
 
 void APP_Spectrum(void) {
+#ifdef ENABLE_CLOSE_CALL
+	CLOSECALL_Cancel();  // The sweep retunes the receiver on its own
+#endif
 	RADIO_EndAudio();  // Just in case audio is open when spectrum starts
 
 	bExit = FALSE;
@@ -733,9 +1447,17 @@ void APP_Spectrum(void) {
 	CurrentStepCountIndex = STEPS_64;
 	CurrentScanDelay = 4;
 	bFilterEnabled = TRUE;
-	SquelchLevel = 0;
+	SquelchMargin = 20;
 	bHold = 0;
 	DisplayMode = 0;
+	TraceMode = TRACE_OFF;
+	TraceShift = 3;
+	PoolMode = POOL_MAX;
+	bRefine = FALSE;
+#ifdef ENABLE_SPECTRUM_RECORDER
+	bRecord = FALSE;
+	bReplay = FALSE;
+#endif
 
 	SetStepCount();
 	SetFreqMinMax(); 
@@ -745,7 +1467,22 @@ void APP_Spectrum(void) {
 	}
 	
 	DISPLAY_Fill(0, 159, 1, 96, COLOR_BACKGROUND);
-	Spectrum_Loop();
 
-	StopSpectrum();
+	CurrentFreqIndex = 0;
+	CurrentFreq = FreqMin;
+	bResetFloor = TRUE;
+	bRestartScan = TRUE;
+	bMultiSegment = FALSE;
+	NoiseFloor[0] = 72 << 4;
+	RssiHigh[0] = 72;
+	UpdateSquelch();
+	UpdateScale();
+
+	//UI_DrawStatusIcon(139, ICON_BATTERY, true, COLOR_FOREGROUND);
+	//UI_DrawBattery(false);
+
+	DrawLabels();
+
+	// Task_Spectrum takes over from here.
+	gScreenMode = SCREEN_SPECTRUM;
 }
@@ -17,7 +17,13 @@
 #ifndef RADIO_SPECTRUM_H
 #define RADIO_SPECTRUM_H
 
+#include <stdbool.h>
+#include <stdint.h>
+
 enum {
+  STEPS_1024,
+  STEPS_512,
+  STEPS_256,
   STEPS_128,
   STEPS_64,
   STEPS_32,
@@ -70,7 +76,7 @@ static const FreqPreset FreqPresets[] = {
     {"CB", 2697500, 2799990, STEPS_128, 3, 0, 1},
     {"10M HAM BAND", 2800000, 2970000, STEPS_128, 1, 2, 1},
     {"6M HAM BAND", 5000000, 5400000, STEPS_128, 1, 2, 1},
-    {"AIR BAND VOICE", 11800000, 13500000, STEPS_128, 10, 1, 1},
+    {"AIR BAND VOICE", 11800000, 13500000, STEPS_512, 8, 1, 1},
     {"2M HAM BAND", 14400000, 14800000, STEPS_128, 8, 0, 0},
     {"RAILWAY", 15175000, 15599990, STEPS_128, 8, 0, 0},
     {"SEA", 15600000, 16327500, STEPS_128, 8, 0, 0},
@@ -91,5 +97,7 @@ static const FreqPreset FreqPresets[] = {
 #endif
 
 void APP_Spectrum(void);
+// Measures the next bin once it has settled, false while there is nothing to do.
+bool SPECTRUM_Step(void);
 
 #endif
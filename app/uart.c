@@ -16,19 +16,32 @@
 
 #include "app/uart.h"
 #include "bsp/gpio.h"
+#ifdef ENABLE_SPECTRUM_RECORDER
+	#include "app/recorder.h"
+#endif
+#ifdef ENABLE_BK4819_TRACE
+	#include "driver/bk4819.h"
+#endif
 #include "driver/pins.h"
 #include "driver/serial-flash.h"
 #include "driver/uart.h"
 #include "radio/hardware.h"
+#include "radio/profiler.h"
+#include "radio/scheduler.h"
 #include "radio/settings.h"
+#ifdef ENABLE_CLOSE_CALL
+	#include "task/closecall.h"
+#endif
+
+#define UART_FRAME_TIMEOUT 100
 
 static uint8_t Buffer[256];
 static uint8_t BufferLength;
 static uint8_t Region;
 static bool bFlashing;
 static uint8_t g_Unused;
+static uint32_t LastByteTime;
 
-uint16_t UART_Timer;
 bool UART_IsRunning;
 
 static uint8_t CalcSum(const uint8_t *pBytes, uint8_t Size)
@@ -118,69 +131,156 @@ static void FlashCmd(uint8_t Command, uint8_t Hi, uint8_t Lo)
 	UART_SendByte(0x06);
 }
 
-void HandlerUSART1(void)
+static void ProcessByte(uint8_t Data)
 {
-	if (USART1->ctrl1_bit.rdbfien && USART1->sts & USART_RDBF_FLAG) {
-		uint8_t Cmd;
+	uint8_t Cmd;
+
+	// Drop a partial frame if the host went quiet in the middle of it.
+	if (BufferLength && gTimeSinceBoot - LastByteTime > UART_FRAME_TIMEOUT) {
+		BufferLength = 0;
+	}
+	LastByteTime = gTimeSinceBoot;
 
-		Buffer[BufferLength++] = USART1->dt;
+	Buffer[BufferLength++] = Data;
 
-		BufferLength %= 256;
-		Cmd = Buffer[0];
-		if (BufferLength == 1 && Cmd != 0x35 && !(Cmd >= 0x40 && Cmd <= 0x4C) && Cmd != 0x52) {
-			UART_IsRunning = false;
-			UART_Timer = 0;
-			UART_SendByte(0xFF);
-			BufferLength = 0;
-		} else {
-			if ((Cmd == 0x35 && BufferLength == 5) || (Cmd == 0x52 && BufferLength == 4) || (Cmd >= 0x40 && Cmd <= 0x4C && BufferLength == 132)) {
-				if (CalcSum(Buffer, BufferLength - 1) == Buffer[BufferLength - 1]) {
-					gpio_bits_flip(GPIOA, BOARD_GPIOA_LED_RED);
-					UART_IsRunning = true;
-					UART_Timer = 1000;
-					if (Cmd == 0x35) {
-						if (Buffer[3] == 16) {
-							g_Unused = 0;
-							UART_SendByte(0x06);
-						} else if (Buffer[3] == 0xEE) {
-							gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_RED);
-							if (bFlashing) {
-								if (Region == 1) {
-									SETTINGS_BackupCalibration();
-								} else if (Region == 2) {
-									SETTINGS_BackupSettings();
-								}
-								gpio_bits_set(GPIOA, BOARD_GPIOA_LED_GREEN);
-								Region = 0;
-								HARDWARE_Reboot();
+	BufferLength %= 256;
+	Cmd = Buffer[0];
+	if (BufferLength == 1 && Cmd != 0x32 && Cmd != 0x35 && !(Cmd >= 0x40 && Cmd <= 0x4C) && Cmd != 0x52
+#ifdef ENABLE_PROFILER
+			&& Cmd != 0x50
+#endif
+#ifdef ENABLE_BK4819_TRACE
+			&& Cmd != 0x54
+#endif
+#ifdef ENABLE_SPECTRUM_RECORDER
+			&& Cmd != 0x57
+#endif
+#ifdef ENABLE_CLOSE_CALL
+			&& Cmd != 0x58
+#endif
+			) {
+		UART_IsRunning = false;
+		SCHEDULER_StopTimer(TIMER_UART);
+		UART_SendByte(0xFF);
+		BufferLength = 0;
+	} else {
+		if ((Cmd == 0x35 && BufferLength == 5) || (Cmd == 0x52 && BufferLength == 4) || (Cmd >= 0x40 && Cmd <= 0x4C && BufferLength == 132)) {
+			if (CalcSum(Buffer, BufferLength - 1) == Buffer[BufferLength - 1]) {
+				gpio_bits_flip(GPIOA, BOARD_GPIOA_LED_RED);
+				UART_IsRunning = true;
+				SCHEDULER_StartTimer(TIMER_UART, 1000);
+				if (Cmd == 0x35) {
+					if (Buffer[3] == 16) {
+						g_Unused = 0;
+						UART_SendByte(0x06);
+					} else if (Buffer[3] == 0xEE) {
+						gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_RED);
+						if (bFlashing) {
+							if (Region == 1) {
+								SETTINGS_BackupCalibration();
+							} else if (Region == 2) {
+								SETTINGS_BackupSettings();
 							}
-							UART_IsRunning = false;
-							UART_Timer = 0;
+							gpio_bits_set(GPIOA, BOARD_GPIOA_LED_GREEN);
+							Region = 0;
+							HARDWARE_Reboot();
 						}
-					} else {
-						FlashCmd(Cmd, Buffer[1], Buffer[2]);
+						UART_IsRunning = false;
+						SCHEDULER_StopTimer(TIMER_UART);
 					}
 				} else {
-					gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_RED);
-					UART_SendByte(0xFF);
+					FlashCmd(Cmd, Buffer[1], Buffer[2]);
 				}
-				BufferLength = 0;
-			} else if (Cmd == 0x32 && BufferLength == 5) {
-				if (CalcSum(Buffer, 4) + 1 == Buffer[4]) {
-					UART_IsRunning = true;
-					UART_Timer = 1000;
-					if (Buffer[3] != 0x16 && Buffer[3] == 0x10) {
-						UART_SendByte(6);
-					}
+			} else {
+				gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_RED);
+				UART_SendByte(0xFF);
+			}
+			BufferLength = 0;
+		} else if (Cmd == 0x32 && BufferLength == 5) {
+			if (CalcSum(Buffer, 4) + 1 == Buffer[4]) {
+				UART_IsRunning = true;
+				SCHEDULER_StartTimer(TIMER_UART, 1000);
+				if (Buffer[3] != 0x16 && Buffer[3] == 0x10) {
+					UART_SendByte(6);
+				}
+			} else {
+				gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_RED);
+				UART_SendByte(0xFF);
+				UART_IsRunning = false;
+				SCHEDULER_StopTimer(TIMER_UART);
+			}
+			BufferLength = 0;
+#ifdef ENABLE_PROFILER
+		} else if (Cmd == 0x50 && BufferLength == 5) {
+			if (CalcSum(Buffer, 4) == Buffer[4]) {
+				if (Buffer[3] == 0) {
+					PROFILER_Dump();
+				} else if (Buffer[3] == 1) {
+					PROFILER_Reset();
+					UART_SendByte(0x06);
+				} else {
+					PROFILER_DumpStack();
+				}
+			} else {
+				UART_SendByte(0xFF);
+			}
+			BufferLength = 0;
+#endif
+#ifdef ENABLE_BK4819_TRACE
+		} else if (Cmd == 0x54 && BufferLength == 5) {
+			if (CalcSum(Buffer, 4) == Buffer[4]) {
+				if (Buffer[3] == 0) {
+					BK4819_TraceDump();
+				} else if (Buffer[3] == 1) {
+					BK4819_TraceDumpStats();
 				} else {
-					gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_RED);
-					UART_SendByte(0xFF);
-					UART_IsRunning = false;
-					UART_Timer = 0;
+					BK4819_TraceReset();
+					UART_SendByte(0x06);
 				}
-				BufferLength = 0;
+			} else {
+				UART_SendByte(0xFF);
 			}
+			BufferLength = 0;
+#endif
+#ifdef ENABLE_SPECTRUM_RECORDER
+		} else if (Cmd == 0x57 && BufferLength == 5) {
+			if (CalcSum(Buffer, 4) == Buffer[4]) {
+				RECORDER_RequestExport();
+			} else {
+				UART_SendByte(0xFF);
+			}
+			BufferLength = 0;
+#endif
+#ifdef ENABLE_CLOSE_CALL
+		} else if (Cmd == 0x58 && BufferLength == 5) {
+			if (CalcSum(Buffer, 4) == Buffer[4]) {
+				if (Buffer[3] == 0) {
+					CLOSECALL_Dump();
+				} else {
+					CLOSECALL_Reset();
+					UART_SendByte(0x06);
+				}
+			} else {
+				UART_SendByte(0xFF);
+			}
+			BufferLength = 0;
+#endif
 		}
 	}
 }
 
+void HandlerUSART1(void)
+{
+	PROFILER_BEGIN();
+
+	if (USART1->ctrl1_bit.tdbeien && USART1->sts & USART_TDBE_FLAG) {
+		UART_HandleTX();
+	}
+	if (USART1->ctrl1_bit.rdbfien && USART1->sts & USART_RDBF_FLAG) {
+		ProcessByte(USART1->dt);
+		SCHEDULER_WakeUp();
+	}
+
+	PROFILER_END(PROFILER_USART1);
+}
+
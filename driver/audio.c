@@ -20,6 +20,8 @@
 #include "driver/serial-flash.h"
 #include "driver/speaker.h"
 #include "misc.h"
+#include "radio/profiler.h"
+#include "radio/scheduler.h"
 #include "radio/settings.h"
 
 static bool bAudioSpeakerEnable;
@@ -33,7 +35,6 @@ static uint16_t SamplePreviousByte;
 static uint16_t SampleCurrentByte;
 static uint32_t SampleReadPosition;
 
-uint16_t gAudioTimer;
 bool gAudioPlaying;
 uint8_t gAudioOffsetLast;
 uint8_t gAudioOffsetIndex;
@@ -106,7 +107,7 @@ static void PlaySample(void)
 		return;
 	}
 
-	if (AudioEndPosition <= SampleReadPosition || gAudioTimer == 0) {
+	if (AudioEndPosition <= SampleReadPosition || !SCHEDULER_IsTimerRunning(TIMER_AUDIO)) {
 		gAudioPlaying = false;
 		TMR6->ctrl1_bit.tmren = FALSE;
 		return;
@@ -142,10 +143,14 @@ static void PlaySample(void)
 
 void HandlerTMR6_GLOBAL(void)
 {
+	PROFILER_BEGIN();
+
 	TMR6->ists = ~TMR_OVF_FLAG;
 	if (gAudioPlaying) {
 		PlaySample();
 	}
+
+	PROFILER_END(PROFILER_TMR6);
 }
 
 //
@@ -172,7 +177,7 @@ void AUDIO_PlaySampleOptional(uint8_t ID)
 	if (gSettings.VoicePrompt) {
 		AudioEndPosition = 0x4000;
 		bPauseTimer = true;
-		gAudioTimer = 3000;
+		SCHEDULER_StartTimer(TIMER_AUDIO, 3000);
 		AUDIO_PlaySample(9375, ID << 14);
 	}
 }
@@ -180,7 +185,7 @@ void AUDIO_PlaySampleOptional(uint8_t ID)
 void AUDIO_PlayChannelNumber(void)
 {
 	PlayNumber(gSettings.VfoChNo[gSettings.CurrentVfo]);
-	gAudioTimer = 350;
+	SCHEDULER_StartTimer(TIMER_AUDIO, 350);
 }
 
 void AUDIO_PlayDigit(uint8_t Digit)
@@ -20,7 +20,6 @@
 #include <stdbool.h>
 #include <stdint.h>
 
-extern uint16_t gAudioTimer;
 extern bool gAudioPlaying;
 extern uint8_t gAudioOffsetLast;
 extern uint8_t gAudioOffsetIndex;
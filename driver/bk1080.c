@@ -33,6 +33,18 @@ static const uint16_t InitTable[] = {
 	0x0000, 0x0000,
 };
 
+#ifndef BK1080_SCL_HZ
+	#define BK1080_SCL_HZ 400000U
+#endif
+
+static uint32_t HalfPeriod;
+static uint32_t Edge;
+
+static void Wait(void)
+{
+	DELAY_WaitEdge(&Edge, HalfPeriod);
+}
+
 static void SDA_SetOutput(void)
 {
 	gpio_init_type init;
@@ -61,11 +73,16 @@ static void SendCommand(uint8_t Command, uint8_t Mode)
 	uint16_t Value;
 	uint8_t i;
 
+	// The FM chip can be switched off before BK1080_Init() ever runs.
+	HalfPeriod = DELAY_GetHalfPeriod(BK1080_SCL_HZ);
+
 	SDA_SetOutput();
 
 	gpio_bits_set(GPIOB, BOARD_GPIOB_BK1080_SDA);
 	gpio_bits_set(GPIOC, BOARD_GPIOC_BK1080_SCL);
+	Wait();
 	gpio_bits_reset(GPIOB, BOARD_GPIOB_BK1080_SDA);
+	Wait();
 	gpio_bits_reset(GPIOC, BOARD_GPIOC_BK1080_SCL);
 
 	Value = 0x80;
@@ -75,12 +92,16 @@ static void SendCommand(uint8_t Command, uint8_t Mode)
 		} else {
 			gpio_bits_reset(GPIOB, BOARD_GPIOB_BK1080_SDA);
 		}
+		Wait();
 		gpio_bits_set(GPIOC, BOARD_GPIOC_BK1080_SCL);
+		Wait();
 		gpio_bits_reset(GPIOC, BOARD_GPIOC_BK1080_SCL);
 		Value = 0;
 	}
 
+	Wait();
 	gpio_bits_set(GPIOC, BOARD_GPIOC_BK1080_SCL);
+	Wait();
 	gpio_bits_reset(GPIOC, BOARD_GPIOC_BK1080_SCL);
 	Value = Command << 1;
 	if (Mode != 0) {
@@ -92,7 +113,9 @@ static void SendCommand(uint8_t Command, uint8_t Mode)
 		} else {
 			gpio_bits_reset(GPIOB, BOARD_GPIOB_BK1080_SDA);
 		}
+		Wait();
 		gpio_bits_set(GPIOC, BOARD_GPIOC_BK1080_SCL);
+		Wait();
 		gpio_bits_reset(GPIOC, BOARD_GPIOC_BK1080_SCL);
 		Value <<= 1;
 	}
@@ -106,12 +129,12 @@ static uint8_t RecvByte(void)
 	SDA_SetOutput();
 
 	gpio_bits_reset(GPIOB, BOARD_GPIOB_BK1080_SDA);
-	DELAY_WaitUS(1);
+	Wait();
 	gpio_bits_set(GPIOC, BOARD_GPIOC_BK1080_SCL);
-	DELAY_WaitUS(1);
+	Wait();
 	gpio_bits_reset(GPIOC, BOARD_GPIOC_BK1080_SCL);
 	gpio_bits_set(GPIOB, BOARD_GPIOB_BK1080_SDA);
-	DELAY_WaitUS(1);
+	Wait();
 
 	SDA_SetInput();
 
@@ -119,20 +142,20 @@ static uint8_t RecvByte(void)
 	for (i = 0; i < 8; i++) {
 		Value <<= 1;
 		gpio_bits_reset(GPIOC, BOARD_GPIOC_BK1080_SCL);
-		DELAY_WaitUS(1);
+		Wait();
 		if (gpio_input_data_bit_read(GPIOB, BOARD_GPIOB_BK1080_SDA)) {
 			Value |= 1;
 		}
 		gpio_bits_set(GPIOC, BOARD_GPIOC_BK1080_SCL);
-		DELAY_WaitUS(1);
+		Wait();
 	}
 
 	SDA_SetOutput();
 
 	gpio_bits_set(GPIOB, BOARD_GPIOB_BK1080_SDA);
-	DELAY_WaitUS(1);
+	Wait();
 	gpio_bits_reset(GPIOC, BOARD_GPIOC_BK1080_SCL);
-	DELAY_WaitUS(1);
+	Wait();
 
 	return Value;
 }
@@ -144,9 +167,9 @@ static void SendByte(uint8_t Value)
 	SDA_SetOutput();
 
 	gpio_bits_reset(GPIOB, BOARD_GPIOB_BK1080_SDA);
-	DELAY_WaitUS(1);
+	Wait();
 	gpio_bits_set(GPIOC, BOARD_GPIOC_BK1080_SCL);
-	DELAY_WaitUS(1);
+	Wait();
 	gpio_bits_reset(GPIOC, BOARD_GPIOC_BK1080_SCL);
 
 	for (i = 0; i < 8; i++) {
@@ -155,8 +178,10 @@ static void SendByte(uint8_t Value)
 		} else {
 			gpio_bits_reset(GPIOB, BOARD_GPIOB_BK1080_SDA);
 		}
+		Wait();
 		gpio_bits_set(GPIOC, BOARD_GPIOC_BK1080_SCL);
 		Value <<= 1;
+		Wait();
 		gpio_bits_reset(GPIOC, BOARD_GPIOC_BK1080_SCL);
 	}
 }
@@ -164,7 +189,7 @@ static void SendByte(uint8_t Value)
 static void StopI2C(void)
 {
 	gpio_bits_set(GPIOC, BOARD_GPIOC_BK1080_SCL);
-	DELAY_WaitUS(1);
+	Wait();
 	gpio_bits_set(GPIOB, BOARD_GPIOB_BK1080_SDA);
 }
 
@@ -172,11 +197,11 @@ static void RenameLater(void)
 {
 	SDA_SetOutput();
 	gpio_bits_reset(GPIOB, BOARD_GPIOB_BK1080_SDA);
-	DELAY_WaitUS(1);
+	Wait();
 	gpio_bits_set(GPIOC, BOARD_GPIOC_BK1080_SCL);
-	DELAY_WaitUS(1);
+	Wait();
 	gpio_bits_reset(GPIOC, BOARD_GPIOC_BK1080_SCL);
-	DELAY_WaitUS(1);
+	Wait();
 
 	StopI2C();
 }
@@ -0,0 +1,144 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include "bsp/gpio.h"
+#include "driver/bk4819-bus.h"
+#include "driver/delay.h"
+#include "driver/pins.h"
+
+#ifndef BK4819_SCL_HZ
+	#define BK4819_SCL_HZ 1000000U
+#endif
+
+static uint32_t HalfPeriod;
+static uint32_t Edge;
+
+static void Wait(void)
+{
+	DELAY_WaitEdge(&Edge, HalfPeriod);
+}
+
+static void SDA_SetOutput(void)
+{
+	gpio_init_type init;
+
+	gpio_default_para_init_ex(&init);
+	init.gpio_pins = BOARD_GPIOB_BK4819_SDA;
+	init.gpio_mode = GPIO_MODE_OUTPUT;
+	init.gpio_out_type = GPIO_OUTPUT_PUSH_PULL;
+	gpio_init(GPIOB, &init);
+}
+
+static void SDA_SetInput(void)
+{
+	gpio_init_type init;
+
+	gpio_default_para_init_ex(&init);
+	init.gpio_pins = BOARD_GPIOB_BK4819_SDA;
+	init.gpio_mode = GPIO_MODE_INPUT;
+	init.gpio_out_type = GPIO_OUTPUT_PUSH_PULL;
+	gpio_init(GPIOB, &init);
+}
+
+static void I2C_Send(uint8_t Data)
+{
+	uint8_t i;
+
+	for (i = 0; i < 8; i++) {
+		gpio_bits_reset(GPIOB, BOARD_GPIOB_BK4819_SCL);
+		if (Data & 0x80U) {
+			gpio_bits_set(GPIOB, BOARD_GPIOB_BK4819_SDA);
+		} else {
+			gpio_bits_reset(GPIOB, BOARD_GPIOB_BK4819_SDA);
+		}
+		Wait();
+		gpio_bits_set(GPIOB, BOARD_GPIOB_BK4819_SCL);
+		Data <<= 1;
+		Wait();
+	}
+}
+
+static uint16_t I2C_RecvU16(void)
+{
+	uint8_t i;
+	uint16_t Data = 0;
+
+	SDA_SetInput();
+
+	gpio_bits_reset(GPIOB, BOARD_GPIOB_BK4819_SCL);
+	for (i = 0; i < 16; i++) {
+		Data <<= 1;
+		gpio_bits_set(GPIOB, BOARD_GPIOB_BK4819_SCL);
+		if (gpio_input_data_bit_read(GPIOB, BOARD_GPIOB_BK4819_SDA)) {
+			Data |= 1;
+		}
+		Wait();
+		gpio_bits_reset(GPIOB, BOARD_GPIOB_BK4819_SCL);
+		Wait();
+	}
+
+	return Data;
+}
+
+// Public
+
+void BK4819_BusInit(void)
+{
+	HalfPeriod = DELAY_GetHalfPeriod(BK4819_SCL_HZ);
+}
+
+uint16_t BK4819_BusRead(uint8_t Reg)
+{
+	uint16_t Data;
+
+	TMR1->ctrl1_bit.tmren = FALSE;
+
+	SDA_SetOutput();
+
+	gpio_bits_reset(GPIOB, BOARD_GPIOB_BK4819_SCL);
+	gpio_bits_reset(GPIOB, BOARD_GPIOB_BK4819_CS);
+	DELAY_StartEdge(&Edge);
+
+	I2C_Send(0x80U | Reg);
+	Wait();
+	Data = I2C_RecvU16();
+
+	gpio_bits_set(GPIOB, BOARD_GPIOB_BK4819_CS);
+
+	TMR1->ctrl1_bit.tmren = TRUE;
+
+	return Data;
+}
+
+void BK4819_BusWrite(uint8_t Reg, uint16_t Data)
+{
+	TMR1->ctrl1_bit.tmren = FALSE;
+
+	SDA_SetOutput();
+
+	gpio_bits_reset(GPIOB, BOARD_GPIOB_BK4819_SCL);
+	gpio_bits_reset(GPIOB, BOARD_GPIOB_BK4819_CS);
+	DELAY_StartEdge(&Edge);
+
+	I2C_Send(Reg);
+	I2C_Send((Data >> 8) & 0xFFU);
+	I2C_Send((Data >> 0) & 0xFFU);
+
+	gpio_bits_set(GPIOB, BOARD_GPIOB_BK4819_CS);
+
+	TMR1->ctrl1_bit.tmren = TRUE;
+}
+
@@ -0,0 +1,30 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef DRIVER_BK4819_BUS_H
+#define DRIVER_BK4819_BUS_H
+
+#include <stdint.h>
+
+// Raw register transfers on the 3-wire bus. Everything above this, including
+// the register shadow, goes through these three calls only, so a model of
+// the chip can stand in for this file.
+void BK4819_BusInit(void);
+uint16_t BK4819_BusRead(uint8_t Reg);
+void BK4819_BusWrite(uint8_t Reg, uint16_t Data);
+
+#endif
+
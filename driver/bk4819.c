@@ -14,14 +14,18 @@
  *     limitations under the License.
  */
 
+#include <string.h>
 #include "app/css.h"
 #include "app/radio.h"
 #include "bsp/gpio.h"
+#include "driver/bk4819-bus.h"
 #include "driver/bk4819.h"
 #include "driver/delay.h"
 #include "driver/pins.h"
 #include "driver/speaker.h"
 #include "misc.h"
+#include "radio/profiler.h"
+#include "radio/scheduler.h"
 #include "radio/settings.h"
 
 enum {
@@ -30,6 +34,109 @@ enum {
 	GPIO_FILTER_UNKWOWN = 1U << 7,
 };
 
+typedef struct {
+	uint8_t Reg;
+	// Bits taken from Data, the others keep their current value.
+	uint16_t Mask;
+	uint16_t Data;
+} ProgramStep_t;
+
+typedef struct {
+	const ProgramStep_t *pSteps;
+	uint8_t Count;
+} Program_t;
+
+#define WRITE(Reg, Data)	{ Reg, 0xFFFFU, Data }
+#define BITS(Reg, Mask, Data)	{ Reg, Mask, Data }
+#define PROGRAM(Steps)		{ Steps, ARRAY_SIZE(Steps) }
+
+static const ProgramStep_t ProgramInit[] = {
+	WRITE(0x00, 0x8000),
+	WRITE(0x00, 0x0000),
+	WRITE(0x37, 0x1D0F),
+	WRITE(0x33, 0x1F00),
+	WRITE(0x35, 0x0000),
+	WRITE(0x1E, 0x4C58),
+	WRITE(0x1F, 0xA656),
+	WRITE(0x3F, 0x0000),
+	WRITE(0x2A, 0x4F18),
+	WRITE(0x53, 0xE678),
+	WRITE(0x2C, 0x5705),
+	WRITE(0x4B, 0x7102),
+	WRITE(0x77, 0x88EF),
+	WRITE(0x26, 0x13A0),
+};
+
+static const ProgramStep_t ProgramRX[] = {
+	WRITE(0x30, 0x0200),
+	WRITE(0x30, 0xBFF1),
+};
+
+static const ProgramStep_t ProgramTxMic[] = {
+	WRITE(0x52, 0x028F),
+	WRITE(0x30, 0x0200),
+	WRITE(0x30, 0xC1FE),
+};
+
+static const ProgramStep_t ProgramTxTone[] = {
+	WRITE(0x52, 0x028F),
+	WRITE(0x30, 0x0200),
+	WRITE(0x30, 0xC3FA),
+};
+
+static const ProgramStep_t ProgramSleep[] = {
+	WRITE(0x30, 0x0000),
+	WRITE(0x37, 0x1D00),
+};
+
+static const ProgramStep_t ProgramFmAudio[] = {
+	WRITE(0x4D, 0xA080),
+	WRITE(0x4E, 0x6F7C),
+	// Auto frequency control on
+	BITS(0x73, 0x0010, 0x0000),
+};
+
+static const ProgramStep_t ProgramAmAudio[] = {
+	// Auto frequency control off
+	BITS(0x73, 0x0010, 0x0010),
+};
+
+static const ProgramStep_t ProgramSsbAudio[] = {
+	BITS(0x73, 0x0010, 0x0010),
+	WRITE(0x43, 0x2058), // Filter 6.25KHz
+	WRITE(0x37, 0x160F),
+	WRITE(0x3D, 0x2B45),
+	WRITE(0x48, 0x03A8),
+};
+
+static const ProgramStep_t ProgramFfskOn[] = {
+	WRITE(0x70, 0x00E0),
+	WRITE(0x72, 0x3065),
+	WRITE(0x58, 0x37C3),
+	WRITE(0x5C, 0x5665),
+	WRITE(0x5D, 0x0F00),
+};
+
+static const ProgramStep_t ProgramFfskOff[] = {
+	WRITE(0x70, 0x0000),
+	WRITE(0x58, 0x0000),
+};
+
+static const Program_t Programs[BK4819_PROGRAM_COUNT] = {
+	[BK4819_PROGRAM_INIT]      = PROGRAM(ProgramInit),
+	[BK4819_PROGRAM_RX]        = PROGRAM(ProgramRX),
+	[BK4819_PROGRAM_TX_MIC]    = PROGRAM(ProgramTxMic),
+	[BK4819_PROGRAM_TX_TONE]   = PROGRAM(ProgramTxTone),
+	[BK4819_PROGRAM_SLEEP]     = PROGRAM(ProgramSleep),
+	[BK4819_PROGRAM_FM_AUDIO]  = PROGRAM(ProgramFmAudio),
+	[BK4819_PROGRAM_AM_AUDIO]  = PROGRAM(ProgramAmAudio),
+	[BK4819_PROGRAM_SSB_AUDIO] = PROGRAM(ProgramSsbAudio),
+	[BK4819_PROGRAM_FFSK_ON]   = PROGRAM(ProgramFfskOn),
+	[BK4819_PROGRAM_FFSK_OFF]  = PROGRAM(ProgramFfskOff),
+};
+
+_Static_assert(BK4819_PROGRAM_COUNT <= PROFILER_TASKS - PROFILER_PROGRAMS, "Too many programs to profile");
+
 static const uint8_t gSquelchGlitchLevel[11] = {
 	0x20,
 	0x20,
@@ -72,73 +179,129 @@ static const uint8_t gSquelchRssiLevel[11] = {
 	0x26,
 };
 
-static void Delay(volatile uint8_t Counter)
-{
-	while (Counter-- > 0) {
-	}
-}
-
-static void SDA_SetOutput(void)
-{
-	gpio_init_type init;
-
-	gpio_default_para_init_ex(&init);
-	init.gpio_pins = BOARD_GPIOB_BK4819_SDA;
-	init.gpio_mode = GPIO_MODE_OUTPUT;
-	init.gpio_out_type = GPIO_OUTPUT_PUSH_PULL;
-	gpio_init(GPIOB, &init);
-}
-
-static void SDA_SetInput(void)
-{
-	gpio_init_type init;
-
-	gpio_default_para_init_ex(&init);
-	init.gpio_pins = BOARD_GPIOB_BK4819_SDA;
-	init.gpio_mode = GPIO_MODE_INPUT;
-	init.gpio_out_type = GPIO_OUTPUT_PUSH_PULL;
-	gpio_init(GPIOB, &init);
-}
-
-
-static void I2C_Send(uint8_t Data)
-{
-	uint8_t i;
-
-	for (i = 0; i < 8; i++) {
-		gpio_bits_reset(GPIOB, BOARD_GPIOB_BK4819_SCL);
-		if (Data & 0x80U) {
-			gpio_bits_set(GPIOB, BOARD_GPIOB_BK4819_SDA);
-		} else {
-			gpio_bits_reset(GPIOB, BOARD_GPIOB_BK4819_SDA);
+// Last value written to, or read from, every register that only the
+// firmware changes. Registers the chip updates by itself always go to the bus.
+static uint16_t Shadow[0x80];
+static uint32_t ShadowValid[0x80 / 32];
+
+#ifdef ENABLE_BK4819_TRACE
+	#include "driver/uart.h"
+
+	#define TRACE_SIZE	64
+	#define TRACE_WRITE	0x80U
+	#define TRACE_BUS	0x01U
+
+	#define TRACE_BEGIN()		const uint32_t TraceStart = DWT->CYCCNT
+	#define TRACE_END(Reg, Flags)	TraceRecord((uint32_t)__builtin_return_address(0), Reg, Flags, DWT->CYCCNT - TraceStart)
+
+	typedef struct __attribute__((packed)) {
+		// Return address into the caller, Thumb bit included.
+		uint32_t Caller;
+		// Register, with TRACE_WRITE set for writes.
+		uint8_t Reg;
+		// TRACE_BUS when the access went to the chip rather than the shadow.
+		uint8_t Flags;
+		uint16_t Cycles;
+	} TraceEntry_t;
+
+	static TraceEntry_t Trace[TRACE_SIZE];
+	static uint32_t TraceCount;
+
+	#define STATS_SIZE	64
+
+	// Totals per tag and register, the write bit masked off.
+	typedef struct __attribute__((packed)) {
+		uint8_t Tag;
+		uint8_t Reg;
+		uint16_t Reads;
+		uint16_t Writes;
+		// Accesses that went to the chip rather than the shadow.
+		uint16_t BusAccesses;
+		uint32_t Cycles;
+	} TraceStats_t;
+
+	static TraceStats_t Stats[STATS_SIZE];
+	static uint32_t StatsDropped;
+	static uint8_t TraceTag;
+
+	static void CountAccess(uint8_t Reg, uint8_t Flags, uint32_t Cycles)
+	{
+		const uint8_t Tag = TraceTag;
+		const bool bWrite = Reg & TRACE_WRITE;
+		uint8_t Slot;
+		uint8_t i;
+
+		Reg &= ~TRACE_WRITE;
+		Slot = (Reg ^ (Tag * 37U)) % STATS_SIZE;
+		for (i = 0; i < STATS_SIZE; i++) {
+			TraceStats_t *pStats = &Stats[Slot];
+
+			if (pStats->Reads == 0 && pStats->Writes == 0) {
+				pStats->Tag = Tag;
+				pStats->Reg = Reg;
+			}
+			if (pStats->Tag == Tag && pStats->Reg == Reg) {
+				if (!bWrite && pStats->Reads != 0xFFFF) {
+					pStats->Reads++;
+				}
+				if (bWrite && pStats->Writes != 0xFFFF) {
+					pStats->Writes++;
+				}
+				if ((Flags & TRACE_BUS) && pStats->BusAccesses != 0xFFFF) {
+					pStats->BusAccesses++;
+				}
+				pStats->Cycles += Cycles;
+				return;
+			}
+			Slot = (Slot + 1) % STATS_SIZE;
 		}
-		Delay(10);
-		gpio_bits_set(GPIOB, BOARD_GPIOB_BK4819_SCL);
-		Data <<= 1;
-		Delay(10);
+		StatsDropped++;
 	}
-}
 
-static uint16_t I2C_RecvU16(void)
-{
-	uint8_t i;
-	uint16_t Data = 0;
+	static void TraceRecord(uint32_t Caller, uint8_t Reg, uint8_t Flags, uint32_t Cycles)
+	{
+		TraceEntry_t *pEntry = &Trace[TraceCount % TRACE_SIZE];
 
-	SDA_SetInput();
+		pEntry->Caller = Caller;
+		pEntry->Reg = Reg;
+		pEntry->Flags = Flags;
+		pEntry->Cycles = Cycles > 0xFFFF ? 0xFFFF : Cycles;
+		TraceCount++;
+		CountAccess(Reg, Flags, Cycles);
+	}
+#else
+	#define TRACE_BEGIN()
+	#define TRACE_END(Reg, Flags)
+#endif
 
-	gpio_bits_reset(GPIOB, BOARD_GPIOB_BK4819_SCL);
-	for (i = 0; i < 16; i++) {
-		Data <<= 1;
-		gpio_bits_set(GPIOB, BOARD_GPIOB_BK4819_SCL);
-		if (gpio_input_data_bit_read(GPIOB, BOARD_GPIOB_BK4819_SDA)) {
-			Data |= 1;
-		}
-		Delay(10);
-		gpio_bits_reset(GPIOB, BOARD_GPIOB_BK4819_SCL);
-		Delay(10);
+// Register 0x0C as last read and the tick it was read in.
+static uint16_t Status;
+static uint32_t StatusTime;
+static bool bStatusValid;
+
+static bool IsStatusRegister(uint8_t Reg)
+{
+	switch (Reg) {
+	case 0x00: // Soft reset
+	case 0x01:
+	case 0x02: // Interrupt flags
+	case 0x0B: // FSK status
+	case 0x0C: // Squelch and interrupt status
+	case 0x0D: // Frequency scan result
+	case 0x0E:
+	case 0x59: // FSK FIFO strobes
+	case 0x5F: // FSK FIFO
+	case 0x63: // Glitch
+	case 0x64: // VOX amplitude
+	case 0x65: // Noise
+	case 0x67: // RSSI
+	case 0x68: // CTCSS scan result
+	case 0x69: // CDCSS scan result
+	case 0x6A:
+		return true;
 	}
 
-	return Data;
+	return false;
 }
 
 #if 0
@@ -156,6 +319,8 @@ static void DisableAGC(uint32_t Unknown)
 
 void OpenAudio(bool bIsNarrow, uint8_t gModulationType)
 {
+	BK4819_TRACE_TAG(BK4819_TAG_AF);
+
 	switch(gModulationType) {
 		case 0:
 			BK4819_SetAF(BK4819_AF_OPEN);
@@ -183,40 +348,122 @@ uint16_t BK4819_ReadRegister(uint8_t Reg)
 {
 	uint16_t Data;
 
-	TMR1->ctrl1_bit.tmren = FALSE;
+	TRACE_BEGIN();
 
-	SDA_SetOutput();
+	if (IsStatusRegister(Reg)) {
+		Data = BK4819_BusRead(Reg);
+	} else if (ShadowValid[Reg / 32] & (1U << (Reg % 32))) {
+		TRACE_END(Reg, 0);
+		return Shadow[Reg];
+	} else {
+		Data = BK4819_BusRead(Reg);
+		Shadow[Reg] = Data;
+		ShadowValid[Reg / 32] |= 1U << (Reg % 32);
+	}
 
-	gpio_bits_reset(GPIOB, BOARD_GPIOB_BK4819_SCL);
-	gpio_bits_reset(GPIOB, BOARD_GPIOB_BK4819_CS);
+	TRACE_END(Reg, TRACE_BUS);
 
-	I2C_Send(0x80U | Reg);
-	Delay(10);
-	Data = I2C_RecvU16();
+	return Data;
+}
 
-	gpio_bits_set(GPIOB, BOARD_GPIOB_BK4819_CS);
+void BK4819_WriteRegister(uint8_t Reg, uint16_t Data)
+{
+	TRACE_BEGIN();
 
-	TMR1->ctrl1_bit.tmren = TRUE;
+	if (Reg == 0x02) {
+		// Clearing the interrupt flags changes 0x0C too.
+		bStatusValid = false;
+	}
+	if (Reg == 0x00 && (Data & 0x8000U)) {
+		// A soft reset returns every register to its default.
+		memset(ShadowValid, 0, sizeof(ShadowValid));
+	} else if (!IsStatusRegister(Reg)) {
+		if ((ShadowValid[Reg / 32] & (1U << (Reg % 32))) && Shadow[Reg] == Data) {
+			TRACE_END(TRACE_WRITE | Reg, 0);
+			return;
+		}
+		Shadow[Reg] = Data;
+		ShadowValid[Reg / 32] |= 1U << (Reg % 32);
+	}
 
-	return Data;
+	BK4819_BusWrite(Reg, Data);
+
+	TRACE_END(TRACE_WRITE | Reg, TRACE_BUS);
 }
 
-void BK4819_WriteRegister(uint8_t Reg, uint16_t Data)
+#ifdef ENABLE_BK4819_TRACE
+void BK4819_TraceReset(void)
 {
-	TMR1->ctrl1_bit.tmren = FALSE;
+	TraceCount = 0;
+	memset(Stats, 0, sizeof(Stats));
+	StatsDropped = 0;
+}
 
-	SDA_SetOutput();
+uint8_t BK4819_TraceSetTag(uint8_t Tag)
+{
+	const uint8_t Outer = TraceTag;
 
-	gpio_bits_reset(GPIOB, BOARD_GPIOB_BK4819_SCL);
-	gpio_bits_reset(GPIOB, BOARD_GPIOB_BK4819_CS);
+	TraceTag = Tag;
 
-	I2C_Send(Reg);
-	I2C_Send((Data >> 8) & 0xFFU);
-	I2C_Send((Data >> 0) & 0xFFU);
+	return Outer;
+}
 
-	gpio_bits_set(GPIOB, BOARD_GPIOB_BK4819_CS);
+void BK4819_TraceRestoreTag(const uint8_t *pTag)
+{
+	TraceTag = *pTag;
+}
 
-	TMR1->ctrl1_bit.tmren = TRUE;
+// Sends the retained entries oldest first, then the total number of accesses
+// recorded so the host can tell how many were overwritten.
+void BK4819_TraceDump(void)
+{
+	const uint32_t Count = TraceCount;
+	uint32_t i;
+
+	i = Count > TRACE_SIZE ? Count - TRACE_SIZE : 0;
+	for (; i < Count; i++) {
+		UART_SendFrame(0x54, &Trace[i % TRACE_SIZE], sizeof(TraceEntry_t));
+	}
+	UART_SendFrame(0x06, &Count, sizeof(Count));
+}
+
+// Sends the totals of every tag and register seen since the last reset, then
+// the number of accesses that found the table full.
+void BK4819_TraceDumpStats(void)
+{
+	uint8_t i;
+
+	for (i = 0; i < STATS_SIZE; i++) {
+		if (Stats[i].Reads || Stats[i].Writes) {
+			UART_SendFrame(0x54, &Stats[i], sizeof(TraceStats_t));
+		}
+	}
+	UART_SendFrame(0x06, &StatsDropped, sizeof(StatsDropped));
+}
+#endif
+
+// Unchanged registers are skipped by BK4819_WriteRegister(), so a program
+// only costs bus time for the registers that actually differ.
+void BK4819_RunProgram(uint8_t Program)
+{
+	const Program_t *pProgram = &Programs[Program];
+	uint8_t i;
+
+	BK4819_TRACE_TAG(BK4819_TAG_PROGRAM);
+
+	PROFILER_BEGIN();
+
+	for (i = 0; i < pProgram->Count; i++) {
+		const ProgramStep_t *pStep = &pProgram->pSteps[i];
+		uint16_t Data = pStep->Data;
+
+		if (pStep->Mask != 0xFFFFU) {
+			Data |= BK4819_ReadRegister(pStep->Reg) & ~pStep->Mask;
+		}
+		BK4819_WriteRegister(pStep->Reg, Data);
+	}
+
+	PROFILER_END(PROFILER_PROGRAMS + Program);
 }
 
 uint16_t BK4819_GetRSSI(void)
@@ -224,24 +471,22 @@ uint16_t BK4819_GetRSSI(void)
 	return BK4819_ReadRegister(0x67) & 0x01FF;
 }
 
+uint8_t BK4819_GetNoise(void)
+{
+	return BK4819_ReadRegister(0x65) & 0x007F;
+}
+
+uint8_t BK4819_GetGlitch(void)
+{
+	return BK4819_ReadRegister(0x63) & 0x00FF;
+}
+
 void BK4819_Init(void)
 {
-	BK4819_WriteRegister(0x00, 0x8000);
-	BK4819_WriteRegister(0x00, 0x0000);
-	BK4819_WriteRegister(0x37, 0x1D0F);
+	BK4819_BusInit();
+	BK4819_RunProgram(BK4819_PROGRAM_INIT);
 	// DisableAGC(0);
-	BK4819_WriteRegister(0x33, 0x1F00);
-	BK4819_WriteRegister(0x35, 0x0000);
-	BK4819_WriteRegister(0x1E, 0x4C58);
-	BK4819_WriteRegister(0x1F, 0xA656);
 	BK4819_WriteRegister(0x3E, gCalibration.BandSelectionThreshold);
-	BK4819_WriteRegister(0x3F, 0x0000);
-	BK4819_WriteRegister(0x2A, 0x4F18);
-	BK4819_WriteRegister(0x53, 0xE678);
-	BK4819_WriteRegister(0x2C, 0x5705);
-	BK4819_WriteRegister(0x4B, 0x7102);
-	BK4819_WriteRegister(0x77, 0x88EF);
-	BK4819_WriteRegister(0x26, 0x13A0);
 	BK4819_SetAFResponseCoefficients(false, true,  gCalibration.RX_3000Hz_Coefficient);
 	BK4819_SetAFResponseCoefficients(false, false, gCalibration.RX_300Hz_Coefficient);
 	BK4819_SetAFResponseCoefficients(true,  true,  gCalibration.TX_3000Hz_Coefficient);
@@ -296,27 +541,51 @@ void BK4819_SetAFResponseCoefficients(bool bTx, bool bLowPass, uint8_t Index)
 
 void BK4819_EnableRX(void)
 {
-	BK4819_WriteRegister(0x37, 0x1F0F);
-	DELAY_WaitMS(10);
-	BK4819_WriteRegister(0x30, 0x0200);
-	BK4819_WriteRegister(0x30, 0xBFF1);
+	// Only wait for the supplies to settle when they were actually off.
+	if (BK4819_ReadRegister(0x37) != 0x1F0F) {
+		BK4819_WriteRegister(0x37, 0x1F0F);
+		DELAY_WaitMS(10);
+	}
+	BK4819_RunProgram(BK4819_PROGRAM_RX);
 }
 
 void BK4819_SetAF(BK4819_AF_Type_t Type)
 {
+	BK4819_TRACE_TAG(BK4819_TAG_AF);
+
 	BK4819_WriteRegister(0x47, 0x6040 | (Type << 8));
 }
 
 void BK4819_SetFrequency(uint32_t Frequency)
 {
+	BK4819_TRACE_TAG(BK4819_TAG_FREQUENCY);
+
 	FREQUENCY_SelectBand(Frequency);
 	Frequency = (Frequency - 32768U) + gFrequencyBandInfo.FrequencyOffset;
 	BK4819_WriteRegister(0x38, (Frequency >>  0) & 0xFFFFU);
 	BK4819_WriteRegister(0x39, (Frequency >> 16) & 0xFFFFU);
 }
 
+void BK4819_TuneFrequency(uint32_t Frequency)
+{
+	uint16_t Value;
+
+	BK4819_TRACE_TAG(BK4819_TAG_FREQUENCY);
+
+	Frequency = (Frequency - 32768U) + gFrequencyBandInfo.FrequencyOffset;
+	BK4819_WriteRegister(0x38, (Frequency >>  0) & 0xFFFFU);
+	BK4819_WriteRegister(0x39, (Frequency >> 16) & 0xFFFFU);
+
+	// Restart the VCO calibration so the PLL locks on the new frequency.
+	Value = BK4819_ReadRegister(0x30);
+	BK4819_WriteRegister(0x30, Value & ~BK4819_REG_30_ENABLE_VCO_CALIB);
+	BK4819_WriteRegister(0x30, Value);
+}
+
 void BK4819_SetSquelchGlitch(bool bIsNarrow)
 {
+	BK4819_TRACE_TAG(BK4819_TAG_SQUELCH);
+
 	if (bIsNarrow) {
 		BK4819_WriteRegister(0x4D, gSquelchGlitchLevel[gSettings.Squelch] + 0x9FFF);
 		BK4819_WriteRegister(0x4E, gSquelchGlitchLevel[gSettings.Squelch] + 0x4DFE);
@@ -331,6 +600,8 @@ void BK4819_SetSquelchNoise(bool bIsNarrow)
 	uint8_t Level;
 	uint16_t Value;
 
+	BK4819_TRACE_TAG(BK4819_TAG_SQUELCH);
+
 	Level = gSquelchNoiseLevel[gSettings.Squelch];
 	if (bIsNarrow) {
 		Value = ((gSquelchNoiseNarrow + 12 + Level) << 8) | (gSquelchNoiseNarrow + 6 + Level);
@@ -346,6 +617,8 @@ void BK4819_SetSquelchRSSI(bool bIsNarrow)
 	uint8_t Level;
 	uint16_t Value;
 
+	BK4819_TRACE_TAG(BK4819_TAG_SQUELCH);
+
 	Level = gSquelchRssiLevel[gSettings.Squelch];
 	if (bIsNarrow) {
 		Value = ((gSquelchRSSINarrow - 8 + Level) << 8) | (gSquelchRSSINarrow - 14 + Level);
@@ -473,16 +746,7 @@ void BK4819_SetToneFrequency(bool Tone2, uint16_t Tone)
 
 void BK4819_EnableFFSK1200(bool bEnable)
 {
-	if (bEnable) {
-		BK4819_WriteRegister(0x70, 0x00E0);
-		BK4819_WriteRegister(0x72, 0x3065);
-		BK4819_WriteRegister(0x58, 0x37C3);
-		BK4819_WriteRegister(0x5C, 0x5665);
-		BK4819_WriteRegister(0x5D, 0x0F00);
-	} else {
-		BK4819_WriteRegister(0x70, 0x0000);
-		BK4819_WriteRegister(0x58, 0x0000);
-	}
+	BK4819_RunProgram(bEnable ? BK4819_PROGRAM_FFSK_ON : BK4819_PROGRAM_FFSK_OFF);
 }
 
 void BK4819_ResetFSK(void)
@@ -497,34 +761,19 @@ void BK4819_StartAudio(void)
 	gpio_bits_set(GPIOA, BOARD_GPIOA_LED_GREEN);
 	gRadioMode = RADIO_MODE_RX;
 	OpenAudio(gMainVfo->bIsNarrow, gMainVfo->gModulationType);
-	if (gMainVfo->gModulationType == 0) {
-		BK4819_WriteRegister(0x4D, 0xA080);
-		BK4819_WriteRegister(0x4E, 0x6F7C);
-	}
-
 	if (gMainVfo->gModulationType > 0) {
 		// AM, SSB
 		BK4819_EnableScramble(0);
 		BK4819_EnableCompander(false);
-		// Set bit 4 of register 73 (Auto Frequency Control Disable)
-		uint16_t reg_73 = BK4819_ReadRegister(0x73);
-		BK4819_WriteRegister(0x73, reg_73 | 0x10U);
 		// BK4819_WriteRegister(0x43, 0b0100000001011000); // Filter 6.25KHz
-		if (gMainVfo->gModulationType > 1) { // if SSB
-			BK4819_WriteRegister(0x43, 0b0010000001011000); // Filter 6.25KHz
-			BK4819_WriteRegister(0x37, 0b0001011000001111);
-    		BK4819_WriteRegister(0x3D, 0b0010101101000101);
-    		BK4819_WriteRegister(0x48, 0b0000001110101000);
-		}
+		BK4819_RunProgram(gMainVfo->gModulationType > 1 ? BK4819_PROGRAM_SSB_AUDIO : BK4819_PROGRAM_AM_AUDIO);
 	} else {
 		// FM
+		BK4819_RunProgram(BK4819_PROGRAM_FM_AUDIO);
 		BK4819_EnableScramble(gMainVfo->Scramble);
 		BK4819_EnableCompander(true);
 		// BK4819_WriteRegister(0x43, 0x3028); // restore filter just in case -
 											// this gets overwritten by sane defaults anyway.
-		// Unset bit 4 of register 73 (Auto Frequency Control Disable)
-		uint16_t reg_73 = BK4819_ReadRegister(0x73);
-		BK4819_WriteRegister(0x73, reg_73 & ~0x10U);
 		if (gMainVfo->Scramble == 0) {
 			BK4819_SetAFResponseCoefficients(false, true, gCalibration.RX_3000Hz_Coefficient);
 		} else {
@@ -539,6 +788,8 @@ void BK4819_StartAudio(void)
 
 void BK4819_SetAfGain(uint16_t Gain)
 {
+	BK4819_TRACE_TAG(BK4819_TAG_AF);
+
 	if (gMainVfo->gModulationType) { // AM, SSB
 		if ((Gain & 15) > 4) {
 			Gain -= 4;
@@ -565,12 +816,25 @@ void BK4819_SetAfGain(uint16_t Gain)
 bool BK4819_CheckSquelchLink(void)
 {
 	if (gSettings.Squelch && !gMonitorMode) {
-		return ((BK4819_ReadRegister(0x0C) >> 1) & 1);
+		return (BK4819_GetStatus() & BK4819_REG_0C_SQUELCH_LINK) != 0;
 	}
 
 	return true;
 }
 
+// There is no interrupt line from the BK4819 to the MCU, so its status is
+// polled. Every caller within the same tick shares a single bus read.
+uint16_t BK4819_GetStatus(void)
+{
+	if (!bStatusValid || StatusTime != gTimeSinceBoot) {
+		Status = BK4819_ReadRegister(0x0C);
+		StatusTime = gTimeSinceBoot;
+		bStatusValid = true;
+	}
+
+	return Status;
+}
+
 void BK4819_EnableTone1(bool bEnable)
 {
 	uint16_t Value;
@@ -656,25 +920,24 @@ void BK4819_SetMicSensitivityTuning(void)
 
 void BK4819_EnableTX(bool bUseMic)
 {
-	BK4819_WriteRegister(0x37, 0x1D0F);
-	DELAY_WaitMS(10);
-	BK4819_WriteRegister(0x52, 0x028F);
-	BK4819_WriteRegister(0x30, 0x0200);
-	if (bUseMic) {
-		BK4819_WriteRegister(0x30, 0xC1FE);
-	} else {
-		BK4819_WriteRegister(0x30, 0xC3FA);
+	if (BK4819_ReadRegister(0x37) != 0x1D0F) {
+		BK4819_WriteRegister(0x37, 0x1D0F);
+		DELAY_WaitMS(10);
 	}
+	BK4819_RunProgram(bUseMic ? BK4819_PROGRAM_TX_MIC : BK4819_PROGRAM_TX_TONE);
 }
 
 void BK4819_StartFrequencyScan(void)
 {
+	BK4819_TRACE_TAG(BK4819_TAG_SCAN);
+
 	BK4819_WriteRegister(0x32, 0x0B01);
-	DELAY_WaitMS(200);
 }
 
 void BK4819_StopFrequencyScan(void)
 {
+	BK4819_TRACE_TAG(BK4819_TAG_SCAN);
+
 	BK4819_WriteRegister(0x32, 0x0000);
 }
 
@@ -684,18 +947,3 @@ void BK4819_DisableAutoCssBW(void)
 	DELAY_WaitMS(200);
 	BK4819_EnableRX();
 }
-
-#ifdef ENABLE_SPECTRUM
-void BK4819_set_rf_frequency(const uint32_t frequency, const bool trigger_update)
-{
-	BK4819_WriteRegister(0x38, (frequency >> 0) & 0xFFFF);
-	BK4819_WriteRegister(0x39, (frequency >> 16) & 0xFFFF);
-
-	if (trigger_update)
-	{ // trigger a PLL/VCO update
-		const uint16_t reg = BK4819_ReadRegister(0x30);
-		BK4819_WriteRegister(0x30, reg & ~BK4819_REG_30_ENABLE_VCO_CALIB);
-		BK4819_WriteRegister(0x30, reg);
-	}
-}
-#endif
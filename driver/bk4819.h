@@ -23,6 +23,9 @@
 #define BK4819_REG_30_SHIFT_ENABLE_VCO_CALIB    15
 #define BK4819_REG_30_ENABLE_VCO_CALIB 			( 1u << BK4819_REG_30_SHIFT_ENABLE_VCO_CALIB)
 
+#define BK4819_REG_0C_INTERRUPT		(1u << 0)
+#define BK4819_REG_0C_SQUELCH_LINK	(1u << 1)
+
 enum BK4819_AF_Type_t {
 	BK4819_AF_MUTE = 0U,
 	BK4819_AF_OPEN = 1U,
@@ -37,10 +40,60 @@ enum BK4819_AF_Type_t {
 
 typedef enum BK4819_AF_Type_t BK4819_AF_Type_t;
 
+// Fixed register sequences applied by BK4819_RunProgram().
+enum {
+	BK4819_PROGRAM_INIT = 0,
+	BK4819_PROGRAM_RX,
+	BK4819_PROGRAM_TX_MIC,
+	BK4819_PROGRAM_TX_TONE,
+	BK4819_PROGRAM_SLEEP,
+	BK4819_PROGRAM_FM_AUDIO,
+	BK4819_PROGRAM_AM_AUDIO,
+	BK4819_PROGRAM_SSB_AUDIO,
+	BK4819_PROGRAM_FFSK_ON,
+	BK4819_PROGRAM_FFSK_OFF,
+	BK4819_PROGRAM_COUNT,
+};
+
+// What the traced register accesses are totalled against. The innermost
+// tagged function wins, untagged callers count as BK4819_TAG_OTHER.
+enum {
+	BK4819_TAG_OTHER = 0,
+	BK4819_TAG_TUNE,
+	BK4819_TAG_FREQUENCY,
+	BK4819_TAG_BAND,
+	BK4819_TAG_SQUELCH,
+	BK4819_TAG_AF,
+	BK4819_TAG_PROGRAM,
+	BK4819_TAG_RX,
+	BK4819_TAG_TX,
+	BK4819_TAG_CSS,
+	BK4819_TAG_SCAN,
+	BK4819_TAG_POLL,
+	BK4819_TAG_SPECTRUM,
+};
+
+#ifdef ENABLE_BK4819_TRACE
+	// Tags the accesses up to the end of the enclosing block.
+	#define BK4819_TRACE_TAG(Tag)	const uint8_t TraceOuterTag __attribute__((cleanup(BK4819_TraceRestoreTag))) = BK4819_TraceSetTag(Tag)
+#else
+	#define BK4819_TRACE_TAG(Tag)
+#endif
+
 void OpenAudio(bool bIsNarrow, uint8_t gModulationType);
 uint16_t BK4819_ReadRegister(uint8_t Reg);
 uint16_t BK4819_GetRSSI();
+uint8_t BK4819_GetNoise(void);
+uint8_t BK4819_GetGlitch(void);
 void BK4819_WriteRegister(uint8_t Reg, uint16_t Data);
+void BK4819_RunProgram(uint8_t Program);
+#ifdef ENABLE_BK4819_TRACE
+void BK4819_TraceReset(void);
+void BK4819_TraceDump(void);
+void BK4819_TraceDumpStats(void);
+uint8_t BK4819_TraceSetTag(uint8_t Tag);
+void BK4819_TraceRestoreTag(const uint8_t *pTag);
+#endif
 
 void BK4819_Init(void);
 void BK4819_SetAFResponseCoefficients(bool bTx, bool bLowPass, uint8_t Index);
@@ -64,6 +117,7 @@ void BK4819_StartAudio(void);
 void BK4819_SetAfGain(uint16_t Gain);
 void BK4819_InitDTMF(void);
 bool BK4819_CheckSquelchLink(void);
+uint16_t BK4819_GetStatus(void);
 void BK4819_EnableTone1(bool bEnable);
 void BK4819_GenTail(bool bIsNarrow);
 void BK4819_SetupPowerAmplifier(uint8_t Bias);
@@ -73,9 +127,8 @@ void BK4819_EnableTX(bool bUseMic);
 void BK4819_StartFrequencyScan(void);
 void BK4819_StopFrequencyScan(void);
 void BK4819_DisableAutoCssBW(void);
-#ifdef ENABLE_SPECTRUM
-void BK4819_set_rf_frequency(const uint32_t frequency, const bool trigger_update);
-#endif
+// Reprograms the PLL only; the band must already be selected.
+void BK4819_TuneFrequency(uint32_t Frequency);
 
 #endif
 
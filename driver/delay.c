@@ -26,6 +26,15 @@ void DELAY_Init(void)
 	systick_clock_source_config(SYSTICK_CLOCK_SOURCE_AHBCLK_NODIV);
 	gCyclesPerMicroSec = gSystemCoreClock / 1000000;
 	gCyclesPerMilliSec = (gSystemCoreClock / 1000000) * 1000;
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+uint32_t DELAY_GetHalfPeriod(uint32_t Frequency)
+{
+	// Round up so the bus never runs faster than requested.
+	return (gSystemCoreClock + (2 * Frequency) - 1) / (2 * Frequency);
 }
 
 void DELAY_WaitUS(uint32_t Delay)
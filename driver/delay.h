@@ -18,10 +18,27 @@
 #define DRIVER_DELAY_H
 
 #include <stdint.h>
+#include <at32f421.h>
 
 void DELAY_Init(void);
+uint32_t DELAY_GetHalfPeriod(uint32_t Frequency);
 void DELAY_WaitUS(uint32_t Delay);
 void DELAY_WaitMS(uint16_t Delay);
 
+// Edge timing for the bit-banged buses. DELAY_WaitEdge() returns once Cycles
+// have passed since the previous edge, so the code run in between counts
+// towards the period instead of adding to it.
+static inline void DELAY_StartEdge(uint32_t *pEdge)
+{
+	*pEdge = DWT->CYCCNT;
+}
+
+static inline void DELAY_WaitEdge(uint32_t *pEdge, uint32_t Cycles)
+{
+	while (DWT->CYCCNT - *pEdge < Cycles) {
+	}
+	*pEdge = DWT->CYCCNT;
+}
+
 #endif
 
@@ -133,3 +133,31 @@ void KEY_ReadSideKeys(void)
 	}
 }
 
+void KEY_SetStandby(bool bStandby)
+{
+	if (bStandby) {
+		// With every column driven low any key pulls its row down, so a
+		// single read covers the whole keypad.
+		gpio_bits_reset(GPIOA, BOARD_GPIOA_KEY_COL3);
+		gpio_bits_reset(GPIOB, BOARD_GPIOB_KEY_COL0);
+		gpio_bits_reset(GPIOB, BOARD_GPIOB_KEY_COL1);
+		gpio_bits_reset(GPIOB, BOARD_GPIOB_KEY_COL2);
+	} else {
+		// Resume the scan where row 0 is driven.
+		gpio_bits_set(GPIOB, BOARD_GPIOB_KEY_COL0);
+		gpio_bits_set(GPIOB, BOARD_GPIOB_KEY_COL1);
+		gpio_bits_set(GPIOB, BOARD_GPIOB_KEY_COL2);
+		RowCounter = 0;
+	}
+}
+
+bool KEY_IsPressed(void)
+{
+	return !gpio_input_data_bit_read(GPIOA, BOARD_GPIOA_KEY_ROW0)
+		|| !gpio_input_data_bit_read(GPIOB, BOARD_GPIOB_KEY_ROW1)
+		|| !gpio_input_data_bit_read(GPIOB, BOARD_GPIOB_KEY_ROW2)
+		|| !gpio_input_data_bit_read(GPIOA, BOARD_GPIOA_KEY_ROW3)
+		|| !gpio_input_data_bit_read(GPIOB, BOARD_GPIOB_KEY_PTT)
+		|| !gpio_input_data_bit_read(GPIOF, BOARD_GPIOF_KEY_SIDE1)
+		|| !gpio_input_data_bit_read(GPIOA, BOARD_GPIOA_KEY_SIDE2);
+}
@@ -51,6 +51,9 @@ extern bool KEY_LongPressed;
 KEY_t KEY_GetButton(void);
 void KEY_ReadButtons(void);
 void KEY_ReadSideKeys(void);
+// Drives every keypad column low so KEY_IsPressed() sees any key at once.
+void KEY_SetStandby(bool bStandby);
+bool KEY_IsPressed(void);
 
 #endif
 
@@ -16,11 +16,16 @@
 
 #include <at32f421.h>
 #include <stdbool.h>
+#include <string.h>
 #include "driver/uart.h"
 #ifdef UART_DEBUG
 	#include "external/printf/printf.h"
 #endif
 
+static uint8_t TxQueue[128];
+static volatile uint8_t TxHead;
+static volatile uint8_t TxTail;
+
 static void usart_reset_ex(usart_type *uart, uint32_t baudrate)
 {
 	crm_clocks_freq_type info;
@@ -67,6 +72,8 @@ void UART_Init(uint32_t BaudRate)
 
 void UART_SendByte(uint8_t Data)
 {
+	while (!(USART1->sts & USART_TDBE_FLAG)) {
+	}
 	USART1->dt = Data;
 	while (!(USART1->sts & USART_TDBE_FLAG)) {
 	}
@@ -82,6 +89,68 @@ void UART_Send(const void *pBuffer, uint8_t Size)
 	}
 }
 
+static uint8_t FrameSum(uint8_t Type, const uint8_t *pBytes, uint8_t Size)
+{
+	uint8_t Sum = Type;
+	uint8_t i;
+
+	for (i = 0; i < Size; i++) {
+		Sum += pBytes[i];
+	}
+
+	return Sum;
+}
+
+void UART_SendFrame(uint8_t Type, const void *pData, uint8_t Size)
+{
+	UART_SendByte(Type);
+	UART_Send(pData, Size);
+	UART_SendByte(FrameSum(Type, pData, Size));
+}
+
+// Returns the frame length, pFrame needs room for Size + 2 bytes.
+uint8_t UART_BuildFrame(uint8_t *pFrame, uint8_t Type, const void *pData, uint8_t Size)
+{
+	pFrame[0] = Type;
+	memcpy(pFrame + 1, pData, Size);
+	pFrame[Size + 1] = FrameSum(Type, pData, Size);
+
+	return Size + 2;
+}
+
+bool UART_Queue(const void *pBuffer, uint8_t Size)
+{
+	const uint8_t *pBytes = (const uint8_t *)pBuffer;
+	uint8_t Head = TxHead;
+	uint8_t i;
+
+	if (Size > ((TxTail - Head - 1) & (sizeof(TxQueue) - 1))) {
+		return false;
+	}
+
+	for (i = 0; i < Size; i++) {
+		TxQueue[Head] = pBytes[i];
+		Head = (Head + 1) & (sizeof(TxQueue) - 1);
+	}
+	TxHead = Head;
+	USART1->ctrl1_bit.tdbeien = TRUE;
+
+	return true;
+}
+
+void UART_HandleTX(void)
+{
+	uint8_t Tail = TxTail;
+
+	if (Tail == TxHead) {
+		USART1->ctrl1_bit.tdbeien = FALSE;
+		return;
+	}
+
+	USART1->dt = TxQueue[Tail];
+	TxTail = (Tail + 1) & (sizeof(TxQueue) - 1);
+}
+
 #ifdef UART_DEBUG
 	void UART_printf(const char *str, ...)
 	{
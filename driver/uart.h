@@ -17,11 +17,17 @@
 #ifndef DRIVER_UART_H
 #define DRIVER_UART_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 void UART_Init(uint32_t BaudRate);
 void UART_SendByte(uint8_t Data);
 void UART_Send(const void *pBuffer, uint8_t Size);
+bool UART_Queue(const void *pBuffer, uint8_t Size);
+// Frames are Type, Size bytes of data and the 8-bit sum of everything before it.
+void UART_SendFrame(uint8_t Type, const void *pData, uint8_t Size);
+uint8_t UART_BuildFrame(uint8_t *pFrame, uint8_t Type, const void *pData, uint8_t Size);
+void UART_HandleTX(void);
 #ifdef UART_DEBUG
 	void UART_printf(const char *str, ...);
 #endif
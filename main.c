@@ -26,10 +26,15 @@
 #include "misc.h"
 #include "radio/data.h"
 #include "radio/hardware.h"
+#include "radio/profiler.h"
+#include "radio/scheduler.h"
 #include "radio/settings.h"
 #include "task/am-fix.h"
 #include "task/alarm.h"
 #include "task/battery.h"
+#ifdef ENABLE_CLOSE_CALL
+	#include "task/closecall.h"
+#endif
 #include "task/cursor.h"
 #include "task/encrypt.h"
 #ifdef ENABLE_FM_RADIO
@@ -43,10 +48,19 @@
 	#include "task/noaa.h"
 #endif
 #include "task/ptt.h"
+#ifdef ENABLE_SPECTRUM_RECORDER
+	#include "task/recorder.h"
+#endif
 #include "task/rssi.h"
 #include "task/scanner.h"
 #include "task/screen.h"
 #include "task/sidekeys.h"
+#ifdef ENABLE_SPECTRUM
+	#include "task/spectrum.h"
+#endif
+#ifdef ENABLE_TELEMETRY
+	#include "task/telemetry.h"
+#endif
 #include "task/timeout.h"
 #include "task/voice.h"
 #include "task/vox.h"
@@ -55,6 +69,84 @@ extern const uint8_t StackVector[];
 
 void Main(void) __attribute__((noreturn));
 
+// A task only runs on the passes where one of its trigger bits is pending.
+typedef struct {
+	void (*pTask)(void);
+	uint32_t Triggers;
+} Task_t;
+
+static const Task_t Tasks[] = {
+	{ SCHEDULER_RunDeferred, TASK_DEFERRED },
+	{ Task_VoicePlayer, TASK_VOICE },
+	{ Task_CheckKeyPad, TASK_CHECK_KEY_PAD },
+	{ Task_CheckSideKeys, TASK_CHECK_SIDE_KEYS },
+	{ Task_UpdateScreen, TASK_UPDATE_SCREEN },
+	{ Task_BlinkCursor, TASK_CURSOR },
+#ifdef ENABLE_AM_FIX
+	{ Task_AM_fix, TASK_AM_FIX },
+#endif
+	{ Task_Scanner, TASK_SCANNER },
+	{ Task_CheckPTT, TASK_CHECK_PTT },
+	{ Task_CheckIncoming, TASK_CHECK_INCOMING },
+	{ Task_CheckRSSI, TASK_CHECK_RSSI },
+	{ Task_CheckDisplayTimeout, TASK_DISPLAY_TIMEOUT },
+	{ Task_Encrypt, TASK_ENCRYPT },
+	{ Task_CheckLockScreen, TASK_LOCK },
+	{ Task_VoxUpdate, TASK_VOX },
+	{ Task_Idle, TASK_IDLE },
+	{ Task_CheckBattery, TASK_CHECK_BATTERY },
+#ifdef ENABLE_FM_RADIO
+	{ Task_CheckScannerFM, TASK_FM_SCANNER },
+#endif
+#ifdef ENABLE_NOAA
+	{ Task_CheckNOAA, TASK_NOAA },
+#endif
+	{ Task_LocalAlarm, TASK_ALARM },
+#ifdef ENABLE_CLOSE_CALL
+	{ Task_CloseCall, TASK_CLOSE_CALL },
+#endif
+#ifdef ENABLE_TELEMETRY
+	{ Task_Telemetry, TASK_TELEMETRY },
+#endif
+#ifdef ENABLE_SPECTRUM_RECORDER
+	{ Task_RecorderExport, TASK_RECORDER },
+#endif
+};
+
+_Static_assert(ARRAY_SIZE(Tasks) <= PROFILER_COUNT - PROFILER_TASKS, "Too many tasks to profile");
+
+#ifdef ENABLE_SPECTRUM
+// The spectrum owns the radio and the keypad, only housekeeping runs beside it.
+static const Task_t SpectrumTasks[] = {
+	{ Task_Spectrum, TASK_SPECTRUM },
+	{ SCHEDULER_RunDeferred, TASK_DEFERRED },
+	{ Task_CheckDisplayTimeout, TASK_DISPLAY_TIMEOUT },
+	{ Task_CheckLockScreen, TASK_LOCK },
+	{ Task_CheckBattery, TASK_CHECK_BATTERY },
+#ifdef ENABLE_TELEMETRY
+	{ Task_Telemetry, TASK_TELEMETRY },
+#endif
+#ifdef ENABLE_SPECTRUM_RECORDER
+	{ Task_RecorderExport, TASK_RECORDER },
+#endif
+};
+
+_Static_assert(ARRAY_SIZE(SpectrumTasks) <= PROFILER_COUNT - PROFILER_SPECTRUM, "Too many spectrum tasks to profile");
+#endif
+
+static void RunTasks(const Task_t *pTasks, uint8_t Count, uint8_t ProfilerBase)
+{
+	uint8_t i;
+
+	for (i = 0; i < Count; i++) {
+		if (SCHEDULER_CheckTask(pTasks[i].Triggers)) {
+			PROFILER_BEGIN();
+			pTasks[i].pTask();
+			PROFILER_END(ProfilerBase + i);
+		}
+	}
+}
+
 void _putchar(char c)
 {
 	UART_SendByte((uint8_t)c);
@@ -66,6 +158,9 @@ void Main(void)
 	CRM_GetCoreClock();
 	SCB->VTOR = (uint32_t)StackVector;
 	DELAY_Init();
+#ifdef ENABLE_PROFILER
+	PROFILER_Init();
+#endif
 	DELAY_WaitMS(200);
 	HARDWARE_Init();
 	RADIO_Init();
@@ -76,37 +171,24 @@ void Main(void)
 	while (1) {
 		do {
 			while (!UART_IsRunning && gSettings.DtmfState != DTMF_STATE_KILLED) {
-				Task_VoicePlayer();
-				Task_CheckKeyPad();
-				Task_CheckSideKeys();
-				Task_UpdateScreen();
-				Task_BlinkCursor();
-				#ifdef ENABLE_AM_FIX
-				Task_AM_fix();
-				#endif
-				Task_Scanner();
-				Task_CheckPTT();
-				Task_CheckIncoming();
-				Task_CheckRSSI();
-				Task_CheckDisplayTimeout();
-				Task_Encrypt();
-				Task_CheckLockScreen();
-				Task_VoxUpdate();
-				Task_Idle();
-				Task_CheckBattery();
-#ifdef ENABLE_FM_RADIO
-				Task_CheckScannerFM();
-#endif
-#ifdef ENABLE_NOAA
-				Task_CheckNOAA();
+#ifdef ENABLE_SPECTRUM
+				if (gScreenMode == SCREEN_SPECTRUM) {
+					RunTasks(SpectrumTasks, ARRAY_SIZE(SpectrumTasks), PROFILER_SPECTRUM);
+					SCHEDULER_Standby();
+					continue;
+				}
 #endif
-				Task_LocalAlarm();
+				RunTasks(Tasks, ARRAY_SIZE(Tasks), PROFILER_TASKS);
+				SCHEDULER_Standby();
 			}
+			// The deferred slot does not run from here, so a roger beep
+			// would leave the PA keyed for the whole UART session.
+			RADIO_StopRogerBeep();
+			SCHEDULER_Sleep();
 		} while (gSettings.DtmfState != DTMF_STATE_KILLED);
-		if (BK4819_ReadRegister(0x0C) & 0x0001U) {
+		if (BK4819_GetStatus() & BK4819_REG_0C_INTERRUPT) {
 			DATA_ReceiverCheck();
 		}
-		DELAY_WaitMS(1);
 		STANDBY_BlinkGreen();
 	}
 }
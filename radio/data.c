@@ -180,11 +180,11 @@ void DATA_SendDeviceName(void)
 	BK4819_WriteRegister(0x59, 0x2828);
 
 	for (i = 0; i < 200; i++) {
-		const uint16_t Value = BK4819_ReadRegister(0x0C);
+		const uint16_t Value = BK4819_GetStatus();
 
 		DELAY_WaitMS(5);
 
-		if (Value & 1U) {
+		if (Value & BK4819_REG_0C_INTERRUPT) {
 			break;
 		}
 	}
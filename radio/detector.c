@@ -19,7 +19,6 @@
 #include "driver/audio.h"
 #include "driver/beep.h"
 #include "driver/bk4819.h"
-#include "driver/delay.h"
 #include "driver/key.h"
 #include "driver/pins.h"
 #include "driver/speaker.h"
@@ -35,6 +34,20 @@
 #include "ui/helper.h"
 #include "ui/main.h"
 
+enum {
+	SCAN_STATE_IDLE = 0,
+	SCAN_STATE_SETTLE,
+	SCAN_STATE_SEARCH,
+};
+
+enum {
+	SCAN_PENDING = 0,
+	SCAN_FOUND,
+	SCAN_NOT_FOUND,
+};
+
+static uint8_t ScanState;
+
 //
 
 static uint32_t RoundToNearest50(uint32_t Frequency)
@@ -49,43 +62,89 @@ static uint32_t RoundToNearest50(uint32_t Frequency)
 	return Value;
 }
 
-static bool CheckScanResult(void)
+// Undoes the harmonic the selected filter lets through to the counter.
+static uint32_t UndoHarmonic(uint32_t Frequency, bool bUseVHF)
+{
+	if (!bUseVHF || Frequency <= 24000000) {
+		if (!bUseVHF && Frequency < 24000000) {
+			Frequency *= 2U;
+		}
+	} else {
+		Frequency /= 2U;
+	}
+
+	return Frequency;
+}
+
+// Turns the frequency scan result from 0x0D/0x0E into the frequency of the
+// transmitter, allowing for the harmonic the selected filter lets through.
+uint32_t RADIO_ScanToFrequency(uint32_t Frequency, bool bUseVHF)
+{
+	Frequency = UndoHarmonic(Frequency, bUseVHF);
+
+	return RoundToNearest50(32808U + (Frequency - FREQUENCY_GetOffset(Frequency)));
+}
+
+uint32_t RADIO_ConvertScanFrequency(uint32_t Frequency, bool bUseVHF)
+{
+	FREQUENCY_SelectBand(UndoHarmonic(Frequency, bUseVHF));
+
+	return RADIO_ScanToFrequency(Frequency, bUseVHF);
+}
+
+static void StopScan(void)
+{
+	if (ScanState != SCAN_STATE_IDLE) {
+		BK4819_StopFrequencyScan();
+		ScanState = SCAN_STATE_IDLE;
+	}
+}
+
+static uint8_t CheckScanResult(void)
 {
 	uint32_t Frequency;
-	uint16_t Timeout;
 	uint16_t Result;
 
-	Timeout = 1000;
-	while (Timeout) {
-		DELAY_WaitMS(1);
-		Result = BK4819_ReadRegister(0x0D);
-		if ((Result & 0x8000U) == 0) {
-			break;
+	BK4819_TRACE_TAG(BK4819_TAG_SCAN);
+
+	switch (ScanState) {
+	case SCAN_STATE_IDLE:
+		BK4819_StartFrequencyScan();
+		SCHEDULER_StartTimer(TIMER_DETECTOR_SCAN, 200);
+		ScanState = SCAN_STATE_SETTLE;
+		return SCAN_PENDING;
+
+	case SCAN_STATE_SETTLE:
+		if (SCHEDULER_IsTimerRunning(TIMER_DETECTOR_SCAN)) {
+			return SCAN_PENDING;
 		}
-		Timeout--;
+		SCHEDULER_StartTimer(TIMER_DETECTOR_SCAN, 1000);
+		ScanState = SCAN_STATE_SEARCH;
+		return SCAN_PENDING;
+
+	default:
+		break;
 	}
 
-	if (!Timeout) {
-		return false;
+	Result = BK4819_ReadRegister(0x0D);
+	if (Result & 0x8000U) {
+		if (SCHEDULER_IsTimerRunning(TIMER_DETECTOR_SCAN)) {
+			return SCAN_PENDING;
+		}
+		StopScan();
+		return SCAN_NOT_FOUND;
 	}
 
 	Frequency = (Result & 0x07FF) << 16;
 	Frequency |= BK4819_ReadRegister(0x0E);
+	StopScan();
 
-	if (!gSettings.bUseVHF || Frequency <= 24000000) {
-		if (!gSettings.bUseVHF && Frequency < 24000000) {
-			Frequency *= 2U;
-		}
-	} else {
-		Frequency /= 2U;
-	}
-	FREQUENCY_SelectBand(Frequency);
-	Frequency = RoundToNearest50(32808U + (Frequency - gFrequencyBandInfo.FrequencyOffset));
+	Frequency = RADIO_ConvertScanFrequency(Frequency, gSettings.bUseVHF);
 	gVfoState[gSettings.CurrentVfo].RX.Frequency = Frequency;
 	gVfoState[gSettings.CurrentVfo].TX.Frequency = Frequency;
 	UI_DrawScanFrequency(Frequency);
 
-	return true;
+	return SCAN_FOUND;
 }
 
 static void UpdateBand(bool bToggleBand)
@@ -162,74 +221,75 @@ static bool GetDcsCode(uint32_t Golay)
 	return false;
 }
 
-static void MuteCtcssScan(void)
+// Polls the CTCSS/DCS detector once, returns true when it is done.
+static bool MuteCtcssScan(void)
 {
-	uint16_t Timeout = 1000;
+	uint32_t Code;
 
-	while (1) {
-		uint32_t Code;
+	BK4819_TRACE_TAG(BK4819_TAG_CSS);
 
-		if (Timeout == 0) {
-			VFO_ClearMute();
-			VFO_ClearCss();
-			UI_DrawNone();
-			break;
+	if (!SCHEDULER_IsTimerRunning(TIMER_DETECTOR_SCAN)) {
+		VFO_ClearMute();
+		VFO_ClearCss();
+		UI_DrawNone();
+		return true;
+	}
+	Code = BK4819_ReadRegister(0x69);
+	if ((Code & 0x8000U) == 0) {
+		if (Code & 0x4000U) {
+			gVfoState[gSettings.CurrentVfo].bIs24Bit = 1;
+		} else {
+			gVfoState[gSettings.CurrentVfo].bIs24Bit = 0;
 		}
-		DELAY_WaitMS(1);
-		Code = BK4819_ReadRegister(0x69);
-		Timeout--;
-		if ((Code & 0x8000U) == 0) {
-			if (Code & 0x4000U) {
-				gVfoState[gSettings.CurrentVfo].bIs24Bit = 1;
-			} else {
-				gVfoState[gSettings.CurrentVfo].bIs24Bit = 0;
-			}
 
-			// Double check the assembly, it didn't make sense!
-			Code = (Code & 0xFFF) << 16;
-			Code |= BK4819_ReadRegister(0x6A) & 0xFFF;
-			gVfoState[gSettings.CurrentVfo].Golay = Code;
-
-			if ((Code & 0XFFFFFF) != 0x555555 && (Code & 0xFFFFFF) != 0xAAAAAA) {
-				if (Code != 0x800000 && (Code & 0xFFFFFF) != 0xFFFFFF && (Code & 0xFFFFFF) != 0x7FFFFF) {
-					if (!gVfoState[gSettings.CurrentVfo].bIs24Bit) {
-						Code &= 0x7FFFFF;
-						gVfoState[gSettings.CurrentVfo].Golay = Code;
-						if (GetDcsCode(Code)) {
-							VFO_ClearMute();
-							break;
-						}
+		// REG_69[11:0] holds bits 23:12 of the code word, REG_6A[11:0] bits
+		// 11:0.
+		Code = (Code & 0xFFF) << 12;
+		Code |= BK4819_ReadRegister(0x6A) & 0xFFF;
+		gVfoState[gSettings.CurrentVfo].Golay = Code;
+
+		if ((Code & 0XFFFFFF) != 0x555555 && (Code & 0xFFFFFF) != 0xAAAAAA) {
+			if (Code != 0x800000 && (Code & 0xFFFFFF) != 0xFFFFFF && (Code & 0xFFFFFF) != 0x7FFFFF) {
+				if (!gVfoState[gSettings.CurrentVfo].bIs24Bit) {
+					Code &= 0x7FFFFF;
+					gVfoState[gSettings.CurrentVfo].Golay = Code;
+					if (GetDcsCode(Code)) {
+						VFO_ClearMute();
+						return true;
 					}
-					gVfoState[gSettings.CurrentVfo].bMuteEnabled = 1;
-					UI_DrawMuteInfo(gVfoState[gSettings.CurrentVfo].bIs24Bit, gVfoState[gSettings.CurrentVfo].Golay);
-				} else {
-					VFO_ClearMute();
-					VFO_ClearCss();
-					UI_DrawNone();
 				}
-				break;
+				gVfoState[gSettings.CurrentVfo].bMuteEnabled = 1;
+				UI_DrawMuteInfo(gVfoState[gSettings.CurrentVfo].bIs24Bit, gVfoState[gSettings.CurrentVfo].Golay);
+			} else {
+				VFO_ClearMute();
+				VFO_ClearCss();
+				UI_DrawNone();
 			}
+			return true;
 		}
-		VFO_ClearMute();
-		Code = BK4819_ReadRegister(0x68);
-		if ((Code & 0x8000U) == 0) {
-			Code = (((Code & 0xFFFU) * 200U) / 412U) + 1U;
-			if (Code > 500) {
-				Code &= 0xFFFU;
-				gVfoState[gSettings.CurrentVfo].RX.Code = Code;
-				gVfoState[gSettings.CurrentVfo].TX.Code = Code;
-				gVfoState[gSettings.CurrentVfo].RX.CodeType = CODE_TYPE_CTCSS;
-				gVfoState[gSettings.CurrentVfo].TX.CodeType = CODE_TYPE_CTCSS;
-				UI_DrawCtcssCode(Code);
-				break;
-			}
+	}
+	VFO_ClearMute();
+	Code = BK4819_ReadRegister(0x68);
+	if ((Code & 0x8000U) == 0) {
+		Code = (((Code & 0xFFFU) * 200U) / 412U) + 1U;
+		if (Code > 500) {
+			Code &= 0xFFFU;
+			gVfoState[gSettings.CurrentVfo].RX.Code = Code;
+			gVfoState[gSettings.CurrentVfo].TX.Code = Code;
+			gVfoState[gSettings.CurrentVfo].RX.CodeType = CODE_TYPE_CTCSS;
+			gVfoState[gSettings.CurrentVfo].TX.CodeType = CODE_TYPE_CTCSS;
+			UI_DrawCtcssCode(Code);
+			return true;
 		}
 	}
+
+	return false;
 }
 
 static void DETECTOR_Loop(void)
 {
 	bool bCtdcScan;
+	bool bCssScan;
 	bool bScan;
 	KEY_t Key;
 
@@ -240,16 +300,18 @@ static void DETECTOR_Loop(void)
 		DISPLAY_Fill(80, 159, 8, 40, COLOR_BACKGROUND);
 		gRxLinkCounter = 0;
 		do {
-			if (gRxLinkCounter == 0 && !bCtdcScan) {
-				BK4819_StartFrequencyScan();
-				bScan = CheckScanResult();
-				BK4819_StopFrequencyScan();
-				if (bScan) {
-					RADIO_Tune(gSettings.CurrentVfo);
+			if ((gRxLinkCounter == 0 || ScanState != SCAN_STATE_IDLE) && !bCtdcScan) {
+				const uint8_t Result = CheckScanResult();
+
+				if (Result != SCAN_PENDING) {
+					bScan = Result == SCAN_FOUND;
+					if (bScan) {
+						RADIO_Tune(gSettings.CurrentVfo);
+					}
 				}
 			}
-			DELAY_WaitMS(5);
-			if (gRxLinkCounter++ > 20) {
+			SCHEDULER_Delay(5);
+			if (ScanState == SCAN_STATE_IDLE && gRxLinkCounter++ > 20) {
 				gRxLinkCounter = 0;
 			}
 			Key = KEY_GetButton();
@@ -275,8 +337,9 @@ static void DETECTOR_Loop(void)
 				Key = KEY_CurrentKey;
 			}
 			KEY_CurrentKey = Key;
-		} while ((!bScan || !BK4819_CheckSquelchLink()) && gpio_input_data_bit_read(GPIOB, BOARD_GPIOB_KEY_PTT));
+		} while ((ScanState != SCAN_STATE_IDLE || !bScan || !BK4819_CheckSquelchLink()) && gpio_input_data_bit_read(GPIOB, BOARD_GPIOB_KEY_PTT));
 
+		StopScan();
 		if (!gpio_input_data_bit_read(GPIOB, BOARD_GPIOB_KEY_PTT)) {
 			gPttPressed = true;
 			KEY_SideKeyLongPressed = false;
@@ -286,10 +349,9 @@ static void DETECTOR_Loop(void)
 			return;
 		}
 		BK4819_DisableAutoCssBW();
-		MuteCtcssScan();
+		SCHEDULER_StartTimer(TIMER_DETECTOR_SCAN, 1000);
+		bCssScan = true;
 		KEY_CurrentKey = KEY_NONE;
-		RADIO_Tune(gSettings.CurrentVfo);
-		gSignalFound = false;
 		Key = KEY_CurrentKey;
 		while (1) {
 			KEY_CurrentKey = Key;
@@ -301,10 +363,18 @@ static void DETECTOR_Loop(void)
 				BEEP_Play(440, 4, 80);
 				return;
 			}
+			// Like the carrier search above, the code search takes one step
+			// per pass, with the keys and the receiver polled beside it.
+			if (bCssScan && MuteCtcssScan()) {
+				bCssScan = false;
+				RADIO_Tune(gSettings.CurrentVfo);
+				gSignalFound = false;
+			}
+			SCHEDULER_Sleep();
 			Key = KEY_GetButton();
 			Task_CheckIncoming();
 			Task_CheckRSSI();
-			if (bCtdcScan && gSignalFound && gRadioMode != RADIO_MODE_QUIET && gDetectorTimer == 0) {
+			if (bCtdcScan && gSignalFound && gRadioMode != RADIO_MODE_QUIET && !SCHEDULER_IsTimerRunning(TIMER_DETECTOR)) {
 				CtdcScan();
 				break;
 			}
@@ -360,6 +430,7 @@ static void DETECTOR_Loop(void)
 
 void RADIO_FrequencyDetect(void)
 {
+	RADIO_StopRogerBeep();
 	SPEAKER_State = 0;
 	gpio_bits_reset(GPIOA, BOARD_GPIOA_SPEAKER);
 	gAudioOffsetIndex = gAudioOffsetLast;
@@ -17,6 +17,13 @@
 #ifndef RADIO_DETECTOR_H
 #define RADIO_DETECTOR_H
 
+#include <stdbool.h>
+#include <stdint.h>
+
+// Leaves the band selection, the filter and the squelch tables alone.
+uint32_t RADIO_ScanToFrequency(uint32_t Frequency, bool bUseVHF);
+// Same, and selects the band of the result first.
+uint32_t RADIO_ConvertScanFrequency(uint32_t Frequency, bool bUseVHF);
 void RADIO_FrequencyDetect(void);
 
 #endif
@@ -20,7 +20,8 @@
 FrequencyBandInfo_t gFrequencyBandInfo;
 bool gUseUhfFilter;
 
-uint8_t gCurrentFrequencyBand = 0xFF;
+uint8_t gCurrentFrequencyBand = BAND_NONE;
+static uint8_t CurrentLevel;
 
 uint8_t gTxPowerLevelHigh = 40;
 uint8_t gTxPowerLevelLow = 20;
@@ -51,50 +52,57 @@ uint32_t FREQUENCY_GetStep(uint8_t StepSetting)
 	}
 }
 
-void FREQUENCY_SelectBand(uint32_t Frequency)
+// The band Frequency falls in and its calibration level, BAND_NONE if none.
+static uint8_t FindBand(uint32_t Frequency, uint8_t *pLevel)
 {
-	uint8_t Band;
-	uint8_t Level;
-
 	if (Frequency >= 13600000  && Frequency <= 17400000) {
-		Band = BAND_136MHz;
-		Level = (Frequency - 13500000) / 500000;
-		gUseUhfFilter = false;
+		*pLevel = (Frequency - 13500000) / 500000;
+		return BAND_136MHz;
 	} else if (Frequency >= 40000000 && Frequency <= 48000000) {
-		Band = BAND_400MHz;
-		Level = (Frequency - 40000000) / 500000;
-		gUseUhfFilter = true;
+		*pLevel = (Frequency - 40000000) / 500000;
+		return BAND_400MHz;
 	} else if (Frequency >= 6400000 && Frequency <= 13600000) {
-		Band = BAND_64MHz;
-		Level = (Frequency - 6000000) / 500000;
-		gUseUhfFilter = false;
+		*pLevel = (Frequency - 6000000) / 500000;
+		return BAND_64MHz;
 	} else if (Frequency >= 17400000 && Frequency <= 24000000) {
-		Band = BAND_174MHz;
-		Level = (Frequency - 17000000) / 500000;
-		gUseUhfFilter = false;
+		*pLevel = (Frequency - 17000000) / 500000;
+		return BAND_174MHz;
 	} else if (Frequency >= 24000000 && Frequency <= 32000000) {
-		Band = BAND_240MHz;
-		Level = (Frequency - 24000000) / 500000;
-		gUseUhfFilter = true;
+		*pLevel = (Frequency - 24000000) / 500000;
+		return BAND_240MHz;
 	} else if (Frequency >= 32000000 && Frequency <= 40000000) {
-		Band = BAND_320MHz;
-		Level = (Frequency - 32000000) / 500000;
-		gUseUhfFilter = true;
+		*pLevel = (Frequency - 32000000) / 500000;
+		return BAND_320MHz;
 	} else if (Frequency >= 48000000 && Frequency <= 56000000) {
-		Band = BAND_480MHz;
-		Level = (Frequency - 48000000) / 500000;
-		gUseUhfFilter = true;
-	} else {
-		return;
+		*pLevel = (Frequency - 48000000) / 500000;
+		return BAND_480MHz;
 	}
 
-	if (Band != gCurrentFrequencyBand) {
-		gCurrentFrequencyBand = Band;
-		SFLASH_Read(&gFrequencyBandInfo, 0x3BF020 + (Band * sizeof(gFrequencyBandInfo)), sizeof(gFrequencyBandInfo));
+	return BAND_NONE;
+}
+
+bool FREQUENCY_SelectBand(uint32_t Frequency)
+{
+	uint8_t Band;
+	uint8_t Level;
+
+	Band = FindBand(Frequency, &Level);
+	if (Band == BAND_NONE) {
+		return false;
 	}
+	gUseUhfFilter = Band != BAND_136MHz && Band != BAND_64MHz && Band != BAND_174MHz;
+
 	if (Level > 15) {
 		Level = 15;
 	}
+	if (Band == gCurrentFrequencyBand && Level == CurrentLevel) {
+		return false;
+	}
+	if (Band != gCurrentFrequencyBand) {
+		gCurrentFrequencyBand = Band;
+		SFLASH_Read(&gFrequencyBandInfo, 0x3BF020 + (Band * sizeof(gFrequencyBandInfo)), sizeof(gFrequencyBandInfo));
+	}
+	CurrentLevel = Level;
 
 	gSquelchNoiseWide = gFrequencyBandInfo.SquelchNoiseWide[Level];
 	gSquelchRSSIWide = gFrequencyBandInfo.SquelchRSSIWide[Level];
@@ -106,5 +114,22 @@ void FREQUENCY_SelectBand(uint32_t Frequency)
 	gTxPowerLevelHigh = gFrequencyBandInfo.TxPowerLevelHigh[Level];
 	gSquelchNoiseNarrow = gFrequencyBandInfo.SquelchNoiseNarrow[Level];
 	gSquelchRSSINarrow = gFrequencyBandInfo.SquelchRSSINarrow[Level];
+
+	return true;
 }
 
+uint16_t FREQUENCY_GetOffset(uint32_t Frequency)
+{
+	uint16_t Offset;
+	uint8_t Band;
+	uint8_t Level;
+
+	Band = FindBand(Frequency, &Level);
+	if (Band == BAND_NONE || Band == gCurrentFrequencyBand) {
+		return gFrequencyBandInfo.FrequencyOffset;
+	}
+	// FrequencyOffset leads the band record.
+	SFLASH_Read(&Offset, 0x3BF020 + (Band * sizeof(gFrequencyBandInfo)), sizeof(Offset));
+
+	return Offset;
+}
@@ -28,6 +28,7 @@ enum {
 	BAND_240MHz = 5,
 	BAND_320MHz = 6,
 	BAND_480MHz = 7,
+	BAND_NONE   = 0xFF,
 };
 
 typedef struct __attribute__((packed)) {
@@ -62,7 +63,11 @@ extern uint8_t gSquelchNoiseNarrow;
 extern uint8_t gSquelchRSSINarrow;
 
 uint32_t FREQUENCY_GetStep(uint8_t StepSetting);
-void FREQUENCY_SelectBand(uint32_t Frequency);
+// Returns true when the band or calibration level changed.
+bool FREQUENCY_SelectBand(uint32_t Frequency);
+// The crystal offset calibrated for the band of Frequency, without selecting
+// that band.
+uint16_t FREQUENCY_GetOffset(uint32_t Frequency);
 
 #endif
 
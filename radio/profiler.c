@@ -0,0 +1,122 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <at32f421.h>
+#include "driver/uart.h"
+#include "radio/profiler.h"
+
+#define STACK_PAINT 0xDEADBEEFU
+
+extern uint32_t __bss_end__[];
+extern const uint32_t StackVector[];
+
+static ProfilerEntry_t Entries[PROFILER_COUNT];
+
+static void PaintStack(void)
+{
+	uint32_t *pStack;
+	uint32_t *pEnd;
+
+	__asm volatile ("mov %0, sp" : "=r" (pEnd));
+	// Leave some room for this function and the interrupts that may already be enabled.
+	pEnd -= 16;
+	for (pStack = __bss_end__; pStack < pEnd; pStack++) {
+		*pStack = STACK_PAINT;
+	}
+}
+
+void PROFILER_Init(void)
+{
+	// The cycle counter itself is started by DELAY_Init().
+	PaintStack();
+}
+
+void PROFILER_Record(uint8_t Id, uint32_t Cycles)
+{
+	ProfilerEntry_t *pEntry = &Entries[Id];
+	uint8_t Bits = 32 - __CLZ(Cycles | 1);
+	uint8_t Bucket = Bits <= 7 ? 0 : (Bits - 6) / 2;
+
+	if (Bucket > 7) {
+		Bucket = 7;
+	}
+	pEntry->Count++;
+	pEntry->Total += Cycles;
+	if (pEntry->Max < Cycles) {
+		pEntry->Max = Cycles;
+	}
+	if (pEntry->Histogram[Bucket] != 0xFFFF) {
+		pEntry->Histogram[Bucket]++;
+	}
+}
+
+uint16_t PROFILER_GetStackUsage(void)
+{
+	const uint32_t *pStack = __bss_end__;
+
+	while (*pStack == STACK_PAINT) {
+		pStack++;
+	}
+
+	return StackVector[0] - (uint32_t)pStack;
+}
+
+void PROFILER_Reset(void)
+{
+	uint8_t *pBytes = (uint8_t *)Entries;
+	uint16_t i;
+
+	__disable_irq();
+	for (i = 0; i < sizeof(Entries); i++) {
+		pBytes[i] = 0;
+	}
+	__enable_irq();
+}
+
+void PROFILER_Dump(void)
+{
+	struct __attribute__((packed)) {
+		uint8_t Id;
+		ProfilerEntry_t Entry;
+	} Frame;
+	uint8_t i;
+
+	for (i = 0; i < PROFILER_COUNT; i++) {
+		if (Entries[i].Count == 0) {
+			continue;
+		}
+		Frame.Id = i;
+		__disable_irq();
+		Frame.Entry = Entries[i];
+		__enable_irq();
+		UART_SendFrame(0x50, &Frame, sizeof(Frame));
+	}
+	UART_SendByte(0x06);
+}
+
+void PROFILER_DumpStack(void)
+{
+	const uint16_t Used = PROFILER_GetStackUsage();
+	const uint16_t Size = StackVector[0] - (uint32_t)__bss_end__;
+	uint8_t Reply[4];
+
+	Reply[0] = Used & 0xFF;
+	Reply[1] = Used >> 8;
+	Reply[2] = Size & 0xFF;
+	Reply[3] = Size >> 8;
+	UART_SendFrame(0x53, Reply, sizeof(Reply));
+}
+
@@ -0,0 +1,58 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef RADIO_PROFILER_H
+#define RADIO_PROFILER_H
+
+#include <stdint.h>
+
+enum {
+	PROFILER_TMR1 = 0,
+	PROFILER_TMR6,
+	PROFILER_USART1,
+	PROFILER_PROGRAMS,
+	PROFILER_TASKS = PROFILER_PROGRAMS + 10,
+	PROFILER_SPECTRUM = PROFILER_TASKS + 24,
+	PROFILER_COUNT = PROFILER_SPECTRUM + 8,
+};
+
+#ifdef ENABLE_PROFILER
+	#include <at32f421.h>
+
+	#define PROFILER_BEGIN()	const uint32_t ProfilerStart = DWT->CYCCNT
+	#define PROFILER_END(Id)	PROFILER_Record(Id, DWT->CYCCNT - ProfilerStart)
+
+	typedef struct __attribute__((packed)) {
+		uint32_t Count;
+		uint32_t Max;
+		uint64_t Total;
+		// Bucket i counts runs shorter than 2^(7 + 2 * i) cycles, the last one the rest.
+		uint16_t Histogram[8];
+	} ProfilerEntry_t;
+
+	void PROFILER_Init(void);
+	void PROFILER_Record(uint8_t Id, uint32_t Cycles);
+	uint16_t PROFILER_GetStackUsage(void);
+	void PROFILER_Reset(void);
+	void PROFILER_Dump(void);
+	void PROFILER_DumpStack(void);
+#else
+	#define PROFILER_BEGIN()
+	#define PROFILER_END(Id)
+#endif
+
+#endif
+
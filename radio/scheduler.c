@@ -14,53 +14,238 @@
  *     limitations under the License.
  */
 
+#include <stddef.h>
+#ifdef ENABLE_SPECTRUM_RECORDER
+	#include "app/recorder.h"
+#endif
 #include "app/uart.h"
+#include "bsp/gpio.h"
 #include "bsp/tmr.h"
-#include "driver/audio.h"
 #include "driver/beep.h"
 #include "driver/key.h"
+#include "driver/pins.h"
+#include "driver/speaker.h"
 #include "misc.h"
+#include "radio/profiler.h"
 #include "radio/scheduler.h"
-#include "task/am-fix.h"
+#include "radio/settings.h"
 #include "task/alarm.h"
+#include "task/am-fix.h"
+#ifdef ENABLE_CLOSE_CALL
+	#include "task/closecall.h"
+#endif
 #include "task/cursor.h"
+#include "task/encrypt.h"
+#ifdef ENABLE_FM_RADIO
+	#include "task/fmscanner.h"
+#endif
+#include "task/idle.h"
+#include "task/incoming.h"
 #include "task/lock.h"
 #ifdef ENABLE_NOAA
 	#include "task/noaa.h"
 #endif
+#include "task/rssi.h"
 #include "task/scanner.h"
+#include "task/screen.h"
+#ifdef ENABLE_SPECTRUM
+	#include "task/spectrum.h"
+#endif
+#include "task/timeout.h"
+#include "task/voice.h"
 #include "task/vox.h"
 
-static uint16_t SCHEDULER_Tasks;
+static volatile uint32_t SCHEDULER_Tasks;
 static uint16_t SCHEDULER_Counter;
+static volatile bool bWakeUp;
+static volatile bool bStandby;
+static bool bPttWasPressed;
+
+static uint32_t TimerDeadline[TIMER_COUNT];
+static volatile uint32_t TimerMask;
+static uint32_t NextDeadline;
+static void (*pDeferred)(void);
+
+// Tick length in ms while the MCU idles through a battery save window.
+#define STANDBY_TICK 16U
+
+static void SetTask(uint32_t Task)
+{
+	SCHEDULER_Tasks |= Task;
+}
+
+static void UartTimeout(void)
+{
+	UART_IsRunning = false;
+}
+
+static void RaiseDeferred(void)
+{
+	SetTask(TASK_DEFERRED);
+}
+
+// The display timeout counts whole seconds, so it is checked once a second.
+static void RaiseDisplayTimeout(void)
+{
+	SCHEDULER_StartTimer(TIMER_DISPLAY, 1000);
+	SetTask(TASK_DISPLAY_TIMEOUT);
+}
+
+static void (*const TimerCallback[TIMER_COUNT])(void) = {
+	[TIMER_UART] = UartTimeout,
+	[TIMER_DEFERRED] = RaiseDeferred,
+	[TIMER_DISPLAY] = RaiseDisplayTimeout,
+};
 
 uint32_t gPttTimeout;
 uint16_t ENCRYPT_Timer;
 uint32_t STANDBY_Counter;
-uint32_t gTimeSinceBoot;
+volatile uint32_t gTimeSinceBoot;
 uint16_t gGreenLedTimer;
 
-volatile uint16_t gSpecialTimer;
-uint16_t VOX_Timer;
-uint16_t gIncomingTimer;
-uint16_t gBatteryTimer;
-uint16_t gSaveModeTimer;
-uint32_t gIdleTimer;
-uint16_t gDetectorTimer;
+bool SCHEDULER_CheckTask(uint32_t Task)
+{
+	return SCHEDULER_Tasks & Task;
+}
 
-static void SetTask(uint16_t Task)
+void SCHEDULER_SetTask(uint32_t Task)
 {
+	__disable_irq();
 	SCHEDULER_Tasks |= Task;
+	__enable_irq();
+	bWakeUp = true;
 }
 
-bool SCHEDULER_CheckTask(uint16_t Task)
+void SCHEDULER_ClearTask(uint32_t Task)
 {
-	return SCHEDULER_Tasks & Task;
+	__disable_irq();
+	SCHEDULER_Tasks &= ~Task;
+	__enable_irq();
 }
 
-void SCHEDULER_ClearTask(uint16_t Task)
+void SCHEDULER_WakeUp(void)
 {
-	SCHEDULER_Tasks &= ~Task;
+	bWakeUp = true;
+}
+
+void SCHEDULER_Sleep(void)
+{
+	// Interrupts stay masked so an event raised after the check still ends
+	// the WFI; the handler itself runs once they are unmasked again, after
+	// the flag is cleared, so its wake up is kept for the next call.
+	__disable_irq();
+	if (!bWakeUp) {
+		__WFI();
+	}
+	bWakeUp = false;
+	__enable_irq();
+}
+
+// Waits at least Delay ms with the core asleep; interrupts keep running.
+void SCHEDULER_Delay(uint16_t Delay)
+{
+	if (Delay == 0) {
+		return;
+	}
+
+	// The tick in progress has already partly elapsed, so wait for one more.
+	SCHEDULER_StartTimer(TIMER_DELAY, Delay + 1);
+	while (SCHEDULER_IsTimerRunning(TIMER_DELAY)) {
+		SCHEDULER_Sleep();
+	}
+}
+
+void SCHEDULER_CancelAfter(void)
+{
+	SCHEDULER_StopTimer(TIMER_DEFERRED);
+	SCHEDULER_ClearTask(TASK_DEFERRED);
+	pDeferred = NULL;
+}
+
+bool SCHEDULER_After(uint16_t Delay, void (*pCallback)(void))
+{
+	if (pDeferred) {
+		return false;
+	}
+	pDeferred = pCallback;
+	SCHEDULER_StartTimer(TIMER_DEFERRED, Delay + 1);
+
+	return true;
+}
+
+void SCHEDULER_RunDeferred(void)
+{
+	void (*pCallback)(void) = pDeferred;
+
+	if (!SCHEDULER_CheckTask(TASK_DEFERRED)) {
+		return;
+	}
+
+	SCHEDULER_ClearTask(TASK_DEFERRED);
+
+	// The callback may queue the next step itself.
+	pDeferred = NULL;
+	if (pCallback) {
+		pCallback();
+	}
+}
+
+static void UpdateNextDeadline(void)
+{
+	uint8_t i;
+
+	for (i = 0; i < TIMER_COUNT; i++) {
+		if ((TimerMask & (1U << i)) && (int32_t)(TimerDeadline[i] - NextDeadline) < 0) {
+			NextDeadline = TimerDeadline[i];
+		}
+	}
+}
+
+static void ExpireTimers(void)
+{
+	uint8_t i;
+
+	NextDeadline = gTimeSinceBoot + 0x7FFFFFFFU;
+	for (i = 0; i < TIMER_COUNT; i++) {
+		if (!(TimerMask & (1U << i))) {
+			continue;
+		}
+		if ((int32_t)(TimerDeadline[i] - gTimeSinceBoot) <= 0) {
+			TimerMask &= ~(1U << i);
+			if (TimerCallback[i]) {
+				TimerCallback[i]();
+			}
+			bWakeUp = true;
+		}
+	}
+	UpdateNextDeadline();
+}
+
+void SCHEDULER_StartTimer(uint8_t Timer, uint32_t Delay)
+{
+	const uint32_t Primask = __get_PRIMASK();
+
+	__disable_irq();
+	TimerDeadline[Timer] = gTimeSinceBoot + Delay;
+	if (!TimerMask || (int32_t)(TimerDeadline[Timer] - NextDeadline) < 0) {
+		NextDeadline = TimerDeadline[Timer];
+	}
+	TimerMask |= 1U << Timer;
+	__set_PRIMASK(Primask);
+}
+
+void SCHEDULER_StopTimer(uint8_t Timer)
+{
+	const uint32_t Primask = __get_PRIMASK();
+
+	__disable_irq();
+	TimerMask &= ~(1U << Timer);
+	__set_PRIMASK(Primask);
+}
+
+bool SCHEDULER_IsTimerRunning(uint8_t Timer)
+{
+	return (TimerMask & (1U << Timer)) && (int32_t)(TimerDeadline[Timer] - gTimeSinceBoot) > 0;
 }
 
 void SCHEDULER_Init(void)
@@ -76,98 +261,228 @@ void SCHEDULER_Init(void)
 	TMR1->ctrl1_bit.prben = TRUE;
 	TMR1->iden |= TMR_OVF_INT;
 	TMR1->ctrl1_bit.tmren = TRUE;
+	SCHEDULER_StartTimer(TIMER_DISPLAY, 1000);
 }
 
-void HandlerTMR1_BRK_OVF_TRG_HALL(void)
+// Raises only the tasks that have something to do on this tick, so the loop
+// stays asleep while nothing is pending instead of polling every task every
+// ms. The keys and the PTT are raised on their inputs, every other task on
+// its Task_*Pending() check, the same one it runs behind, and the periodic
+// ones on their rate as well.
+static void RaiseTasks(void)
 {
-	TMR1->ists = ~TMR_OVF_FLAG;
+	const bool bPttPressed = !gpio_input_data_bit_read(GPIOB, BOARD_GPIOB_KEY_PTT);
 
-	KEY_ReadButtons();
-	KEY_ReadSideKeys();
-	BEEP_Interrupt();
+	if (KEY_GetButton() != KEY_NONE || KEY_CurrentKey != KEY_NONE) {
+		SetTask(TASK_CHECK_KEY_PAD);
+	}
+	if (!gpio_input_data_bit_read(GPIOF, BOARD_GPIOF_KEY_SIDE1) || !gpio_input_data_bit_read(GPIOA, BOARD_GPIOA_KEY_SIDE2) || KEY_Side1Counter || KEY_Side2Counter || KEY_SideKeyLongPressed) {
+		SetTask(TASK_CHECK_SIDE_KEYS);
+	}
+	// The release needs one more pass to reset the PTT state.
+	if (bPttPressed || bPttWasPressed || gRadioMode == RADIO_MODE_TX) {
+		SetTask(TASK_CHECK_PTT);
+	}
+	bPttWasPressed = bPttPressed;
 
-	if (gSpecialTimer) {
-		gSpecialTimer--;
+	if (Task_IncomingPending()) {
+		SetTask(TASK_CHECK_INCOMING);
 	}
-	if (gEnableLocalAlarm && !gSendTone) {
-		gAlarmCounter++;
+	if ((SCHEDULER_Counter & 1) == 0 && Task_RssiPending()) {
+		SetTask(TASK_CHECK_RSSI);
 	}
-	if (gAudioTimer) {
-		gAudioTimer--;
+
+	if (Task_VoicePending()) {
+		SetTask(TASK_VOICE);
 	}
-	if (VOX_Timer) {
-		VOX_Timer--;
+	if (Task_ScreenPending()) {
+		SetTask(TASK_UPDATE_SCREEN);
 	}
-	if (gCursorCountdown) {
-		gCursorCountdown--;
+	if (Task_CursorPending()) {
+		SetTask(TASK_CURSOR);
 	}
-	#ifdef ENABLE_AM_FIX
-	if (gAmFixCountdown) {
-		gAmFixCountdown--;
+#ifdef ENABLE_AM_FIX
+	if (Task_AmFixPending()) {
+		SetTask(TASK_AM_FIX);
 	}
-	#endif
-	if (gIncomingTimer) {
-		gIncomingTimer--;
+#endif
+	if (gForceScan) {
+		SetTask(TASK_SCANNER);
 	}
-	if (gVoxRssiUpdateTimer) {
-		gVoxRssiUpdateTimer--;
+	// TIMER_DISPLAY raises the seconds, the green blink needs the ms.
+	if (Task_BlinkPending()) {
+		SetTask(TASK_DISPLAY_TIMEOUT);
 	}
-	if (gBatteryTimer) {
-		gBatteryTimer--;
+	if (Task_EncryptPending()) {
+		SetTask(TASK_ENCRYPT);
 	}
-	#ifdef ENABLE_NOAA
-	if (NOAA_NextChannelCountdown) {
-		NOAA_NextChannelCountdown--;
+	if (Task_IdlePending()) {
+		SetTask(TASK_IDLE);
 	}
-	#endif
-	if (gSaveModeTimer) {
-		gSaveModeTimer--;
+#ifdef ENABLE_NOAA
+	if (Task_NoaaPending()) {
+		SetTask(TASK_NOAA);
+	}
+#endif
+	if (Task_AlarmPending()) {
+		SetTask(TASK_ALARM);
 	}
-	if (gIdleTimer) {
-		gIdleTimer--;
+#ifdef ENABLE_CLOSE_CALL
+	if (Task_CloseCallPending()) {
+		SetTask(TASK_CLOSE_CALL);
 	}
-	if (SCANNER_Countdown) {
-		SCANNER_Countdown--;
+#endif
+#ifdef ENABLE_SPECTRUM_RECORDER
+	if (RECORDER_IsExporting()) {
+		SetTask(TASK_RECORDER);
 	}
-	if (gDetectorTimer) {
-		gDetectorTimer--;
+#endif
+#ifdef ENABLE_SPECTRUM
+	if (Task_SpectrumPending()) {
+		SetTask(TASK_SPECTRUM);
 	}
-	if (UART_Timer) {
-		UART_Timer--;
-	} else {
-		if (UART_IsRunning) {
-			UART_IsRunning = false;
+#endif
+
+	if ((SCHEDULER_Counter & 15) == 0) {
+		if (Task_VoxPending()) {
+			SetTask(TASK_VOX);
+		}
+		if (Task_ScannerPending()) {
+			SetTask(TASK_SCANNER);
+		}
+		if (gSettings.LockTimer) {
+			SetTask(TASK_LOCK);
 		}
 	}
+#ifdef ENABLE_TELEMETRY
+	if ((SCHEDULER_Counter & 63) == 0) {
+		SetTask(TASK_TELEMETRY);
+	}
+#endif
+#ifdef ENABLE_FM_RADIO
+	if ((SCHEDULER_Counter & 127) == 0 && Task_FmScannerPending()) {
+		SetTask(TASK_FM_SCANNER);
+	}
+#endif
+	if ((SCHEDULER_Counter & 0x3FF) == 0) {
+		SetTask(TASK_1024_c | TASK_CHECK_BATTERY);
+		SCHEDULER_Counter = 0;
+	}
+}
+
+static void AdvanceTime(void)
+{
+	if (gEnableLocalAlarm && !gSendTone) {
+		gAlarmCounter++;
+	}
 	if (!VOX_IsTransmitting && gRadioMode == RADIO_MODE_TX) {
 		gPttTimeout++;
 	}
 	gLockTimer++;
 	SCHEDULER_Counter++;
-	ENCRYPT_Timer++;
+	// The scrambler code only flips while transmitting.
+	if (gRadioMode == RADIO_MODE_TX) {
+		ENCRYPT_Timer++;
+	} else {
+		ENCRYPT_Timer = 0;
+	}
 	STANDBY_Counter++;
 	gTimeSinceBoot++;
+	if (TimerMask && (int32_t)(gTimeSinceBoot - NextDeadline) >= 0) {
+		ExpireTimers();
+	}
 	if (gBlinkGreen) {
 		gGreenLedTimer++;
 	}
-	SetTask(TASK_CHECK_SIDE_KEYS | TASK_CHECK_KEY_PAD | TASK_CHECK_PTT | TASK_CHECK_INCOMING);
-	if ((SCHEDULER_Counter & 1) == 0) {
-	//	SetTask(TASK_CHECK_RSSI | TASK_CHECK_INCOMING);
-		SetTask(TASK_CHECK_RSSI);
+	RaiseTasks();
+}
+
+void SCHEDULER_Tick(void)
+{
+	const uint32_t Tasks = SCHEDULER_Tasks;
+
+	KEY_ReadButtons();
+	KEY_ReadSideKeys();
+	BEEP_Interrupt();
+	AdvanceTime();
+	// A killed radio runs no tasks and polls for the revive code every tick.
+	if ((SCHEDULER_Tasks & ~Tasks) || gSettings.DtmfState == DTMF_STATE_KILLED) {
+		bWakeUp = true;
 	}
-	if ((SCHEDULER_Counter & 15) == 0) {
-		// SetTask(TASK_VOX);
-		SetTask(TASK_VOX | TASK_SCANNER);
-	}
-	//if ((SCHEDULER_Counter & 60) == 0) {
-	//	SetTask(TASK_SCANNER);
-	//}
-	if ((SCHEDULER_Counter & 127) == 0) {
-		//SetTask(TASK_FM_SCANNER | TASK_SCANNER);
-		SetTask(TASK_FM_SCANNER);
+}
+
+// Must run from the tick handler or with interrupts masked.
+static void LeaveStandby(void)
+{
+	uint32_t Elapsed;
+
+	Elapsed = TMR1->cval / 1000;
+	if (TMR1->ists & TMR_OVF_FLAG) {
+		TMR1->ists = ~TMR_OVF_FLAG;
+		NVIC_ClearPendingIRQ(TMR1_BRK_OVF_TRG_HALL_IRQn);
+		Elapsed += STANDBY_TICK;
 	}
-	if ((SCHEDULER_Counter & 0x3FF) == 0) {
-		SetTask(TASK_1024_c | TASK_AM_FIX | TASK_CHECK_BATTERY);
-		SCHEDULER_Counter = 0;
+	TMR1->pr = 999;
+	TMR1->cval %= 1000;
+	TMR1->ctrl1_bit.prben = TRUE;
+	KEY_SetStandby(false);
+	bStandby = false;
+	while (Elapsed--) {
+		AdvanceTime();
+	}
+}
+
+static void StandbyTick(void)
+{
+	uint8_t i;
+
+	for (i = 0; i < STANDBY_TICK; i++) {
+		AdvanceTime();
+	}
+	if (KEY_IsPressed() || !TimerMask || (int32_t)(NextDeadline - gTimeSinceBoot) <= (int32_t)STANDBY_TICK) {
+		LeaveStandby();
+		bWakeUp = true;
+	}
+}
+
+void SCHEDULER_Standby(void)
+{
+	__disable_irq();
+	if (!gSaveMode || !SCHEDULER_IsTimerRunning(TIMER_SAVE_MODE) || gBlinkGreen || SPEAKER_State != 0 || KEY_CurrentKey != KEY_NONE || KEY_GetButton() != KEY_NONE || bWakeUp || (TMR1->ists & TMR_OVF_FLAG) || (int32_t)(NextDeadline - gTimeSinceBoot) <= (int32_t)(2 * STANDBY_TICK)) {
+		__enable_irq();
+		SCHEDULER_Sleep();
+		return;
+	}
+
+	// Stretch the tick to STANDBY_TICK ms. The counter keeps its sub-ms
+	// phase so no time is lost on either side of the window.
+	KEY_SetStandby(true);
+	TMR1->ctrl1_bit.prben = FALSE;
+	TMR1->pr = (STANDBY_TICK * 1000) - 1;
+	bStandby = true;
+
+	while (bStandby && !bWakeUp) {
+		__WFI();
+		__enable_irq();
+		__disable_irq();
 	}
+	if (bStandby) {
+		LeaveStandby();
+	}
+	bWakeUp = false;
+	__enable_irq();
+}
+
+void HandlerTMR1_BRK_OVF_TRG_HALL(void)
+{
+	PROFILER_BEGIN();
+
+	TMR1->ists = ~TMR_OVF_FLAG;
+	if (bStandby) {
+		StandbyTick();
+	} else {
+		SCHEDULER_Tick();
+	}
+
+	PROFILER_END(PROFILER_TMR1);
 }
@@ -20,38 +20,90 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+// Raised by the tick when a task has something to do, each task clears its
+// own bit when it runs.
 enum {
-	TASK_CHECK_PTT        = 0x0001U,
-	TASK_CHECK_BATTERY    = 0x0002U,
-	TASK_AM_FIX           = 0x0004U,
-	TASK_SCANNER          = 0x0008U,
-	TASK_1024_c           = 0x0010U,
-	TASK_FM_SCANNER       = 0x0020U,
-	TASK_CHECK_INCOMING   = 0x0040U,
-	TASK_CHECK_RSSI       = 0x0080U,
-	TASK_CHECK_KEY_PAD    = 0x0200U,
-	TASK_CHECK_SIDE_KEYS  = 0x0400U,
-	TASK_VOX              = 0x0800U,
+	TASK_CHECK_PTT        = 0x000001U,
+	TASK_CHECK_BATTERY    = 0x000002U,
+	TASK_AM_FIX           = 0x000004U,
+	TASK_SCANNER          = 0x000008U,
+	TASK_1024_c           = 0x000010U,
+	TASK_FM_SCANNER       = 0x000020U,
+	TASK_CHECK_INCOMING   = 0x000040U,
+	TASK_CHECK_RSSI       = 0x000080U,
+	TASK_TELEMETRY        = 0x000100U,
+	TASK_CHECK_KEY_PAD    = 0x000200U,
+	TASK_CHECK_SIDE_KEYS  = 0x000400U,
+	TASK_VOX              = 0x000800U,
+	TASK_VOICE            = 0x001000U,
+	TASK_UPDATE_SCREEN    = 0x002000U,
+	TASK_CURSOR           = 0x004000U,
+	TASK_DISPLAY_TIMEOUT  = 0x008000U,
+	TASK_ENCRYPT          = 0x010000U,
+	TASK_LOCK             = 0x020000U,
+	TASK_IDLE             = 0x040000U,
+	TASK_NOAA             = 0x080000U,
+	TASK_ALARM            = 0x100000U,
+	TASK_CLOSE_CALL       = 0x200000U,
+	TASK_RECORDER         = 0x400000U,
+	TASK_SPECTRUM         = 0x800000U,
+	TASK_DEFERRED         = 0x1000000U,
+};
+
+// One-shot millisecond timers, checked against gTimeSinceBoot instead of
+// being counted down one by one in the tick interrupt.
+enum {
+	TIMER_SPECIAL = 0,
+	TIMER_AUDIO,
+	TIMER_VOX,
+	TIMER_CURSOR,
+	TIMER_AM_FIX,
+	TIMER_INCOMING,
+	TIMER_VOX_RSSI,
+	TIMER_BATTERY,
+	TIMER_NOAA,
+	TIMER_SAVE_MODE,
+	TIMER_IDLE,
+	TIMER_SCANNER,
+	TIMER_DETECTOR,
+	TIMER_UART,
+	TIMER_DETECTOR_SCAN,
+	TIMER_SPECTRUM,
+	TIMER_CLOSE_CALL,
+	TIMER_DELAY,
+	TIMER_DEFERRED,
+	TIMER_DISPLAY,
+	TIMER_COUNT,
 };
 
 extern uint32_t gPttTimeout;
 extern uint16_t ENCRYPT_Timer;
 extern uint32_t STANDBY_Counter;
-extern uint32_t gTimeSinceBoot;
+extern volatile uint32_t gTimeSinceBoot;
 extern uint16_t gGreenLedTimer;
 
-extern volatile uint16_t gSpecialTimer;
-extern uint16_t VOX_Timer;
-extern uint16_t gIncomingTimer;
-extern uint16_t gBatteryTimer;
-extern uint16_t gSaveModeTimer;
-extern uint32_t gIdleTimer;
-extern uint16_t gDetectorTimer;
-
 void SCHEDULER_Init(void);
-bool SCHEDULER_CheckTask(uint16_t Task);
-void SCHEDULER_SetTask(uint16_t Task);
-void SCHEDULER_ClearTask(uint16_t Task);
+// Advances the firmware clock by 1 ms; only the TMR1 handler calls this on hardware.
+void SCHEDULER_Tick(void);
+bool SCHEDULER_CheckTask(uint32_t Task);
+void SCHEDULER_SetTask(uint32_t Task);
+void SCHEDULER_ClearTask(uint32_t Task);
+void SCHEDULER_StartTimer(uint8_t Timer, uint32_t Delay);
+void SCHEDULER_StopTimer(uint8_t Timer);
+bool SCHEDULER_IsTimerRunning(uint8_t Timer);
+void SCHEDULER_WakeUp(void);
+void SCHEDULER_Sleep(void);
+void SCHEDULER_Delay(uint16_t Delay);
+// Calls pCallback from the task loop once Delay ms have passed, the other
+// tasks keep running meanwhile. There is a single slot and it belongs to the
+// roger beep of app/radio.c; a call while another callback is pending is
+// refused and returns false. The slot only runs while the task loop does.
+bool SCHEDULER_After(uint16_t Delay, void (*pCallback)(void));
+void SCHEDULER_CancelAfter(void);
+void SCHEDULER_RunDeferred(void);
+// Sleeps with a slowed tick while the radio is in a battery save window,
+// falls back to SCHEDULER_Sleep() otherwise.
+void SCHEDULER_Standby(void);
 
 #endif
 
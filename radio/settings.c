@@ -22,6 +22,7 @@
 #include "helper/dtmf.h"
 #include "misc.h"
 #include "radio/hardware.h"
+#include "radio/scheduler.h"
 #include "radio/settings.h"
 #include "task/keyaction.h"
 #include "task/scanner.h"
@@ -140,7 +141,7 @@ void SETTINGS_SaveState(void)
 {
 	gScannerMode = false;
 	gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_GREEN);
-	SCANNER_Countdown = 0;
+	SCHEDULER_StopTimer(TIMER_SCANNER);
 	if (gSettings.WorkMode) {
 		SETTINGS_SaveGlobals();
 	} else {
@@ -20,15 +20,28 @@
 #include "driver/pins.h"
 #include "driver/speaker.h"
 #include "misc.h"
+#include "radio/scheduler.h"
 #include "task/alarm.h"
 
 uint16_t gAlarmFrequency = 800;
 uint8_t gAlarmCounter;
 bool gAlarmSiren;
 
+// gAlarmCounter steps the siren every 16 ms.
+bool Task_AlarmPending(void)
+{
+	return gEnableLocalAlarm && !gSendTone && gAlarmCounter > 15;
+}
+
 void Task_LocalAlarm(void)
 {
-	if (gEnableLocalAlarm && !gSendTone && gAlarmCounter > 15) {
+	if (!SCHEDULER_CheckTask(TASK_ALARM)) {
+		return;
+	}
+
+	SCHEDULER_ClearTask(TASK_ALARM);
+
+	if (Task_AlarmPending()) {
 		gAlarmCounter = 0;
 
 		if (!gAlarmSiren) {
@@ -24,6 +24,7 @@ extern uint16_t gAlarmFrequency;
 extern uint8_t gAlarmCounter;
 extern bool gAlarmSiren;
 
+bool Task_AlarmPending(void);
 void Task_LocalAlarm(void);
 void ALARM_Start(void);
 void ALARM_Stop(void);
@@ -22,6 +22,7 @@
 #include "task/am-fix.h"
 #include "app/radio.h"
 #include "driver/bk4819.h"
+#include "radio/scheduler.h"
 #include "radio/settings.h"
 #include "misc.h"
 
@@ -191,7 +192,6 @@
 	};
 
 	static const unsigned int original_index = 90;
-    uint16_t gAmFixCountdown;
 
 	unsigned int gain_table_index[2] = {original_index, original_index};
 
@@ -251,9 +251,20 @@
 	// won't/don't do it for itself, we're left to bodging it ourself by
 	// playing with the RF front end gain setting
 	//
+	bool Task_AmFixPending(void)
+	{
+		return gExtendedSettings.AmFixEnabled && !SCHEDULER_IsTimerRunning(TIMER_AM_FIX);
+	}
+
 	void Task_AM_fix()
 	{
-        if(gAmFixCountdown != 0 || !gExtendedSettings.AmFixEnabled) return;
+		if (!SCHEDULER_CheckTask(TASK_AM_FIX)) {
+			return;
+		}
+
+		SCHEDULER_ClearTask(TASK_AM_FIX);
+
+        if(!Task_AmFixPending()) return;
         if(gVfoState[gSettings.CurrentVfo].gModulationType == 1) { // AM
             int16_t diff_dB;
             int16_t rssi;
@@ -263,7 +274,7 @@
             {
                     case RADIO_MODE_QUIET:
                     case RADIO_MODE_TX:
-                    gAmFixCountdown = 100;
+                    SCHEDULER_StartTimer(TIMER_AM_FIX, 100);
                     return;
 
                 // only adjust stuff if we're in one of these modes
@@ -357,10 +368,10 @@
             // save the corrected RSSI level
             gCurrentRssi[vfo] = rssi - rssi_gain_diff[vfo];
 
-            gAmFixCountdown = 100;
+            SCHEDULER_StartTimer(TIMER_AM_FIX, 100);
         } else
         {
-			gAmFixCountdown = 1000;
+			SCHEDULER_StartTimer(TIMER_AM_FIX, 1000);
 			BK4819_RestoreGainSettings();
         }
 	}
@@ -22,10 +22,11 @@
 
 #ifdef ENABLE_AM_FIX
 	extern int16_t rssi_gain_diff[2];
-    extern uint16_t gAmFixCountdown;
+	extern unsigned int gain_table_index[2];
 
 	void AM_fix_init(void);
 	void AM_fix_reset(const int vfo);
+	bool Task_AmFixPending(void);
 	void Task_AM_fix(void);
 	#ifdef ENABLE_AM_FIX_SHOW_DATA
 		void AM_fix_print_data(const int vfo, char *s);
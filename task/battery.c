@@ -33,7 +33,7 @@ static uint8_t ChargeTimer;
 
 void Task_CheckBattery(void)
 {
-	if (gRadioMode == RADIO_MODE_TX || !SCHEDULER_CheckTask(TASK_CHECK_BATTERY) || gBatteryTimer) {
+	if (gRadioMode == RADIO_MODE_TX || !SCHEDULER_CheckTask(TASK_CHECK_BATTERY) || SCHEDULER_IsTimerRunning(TIMER_BATTERY)) {
 		return;
 	}
 
@@ -42,7 +42,7 @@ void Task_CheckBattery(void)
 	gBatteryVoltage = BATTERY_GetVoltage();
 
 	if (gRadioMode != RADIO_MODE_RX
-			&& VOX_Timer == 0
+			&& !SCHEDULER_IsTimerRunning(TIMER_VOX)
 #ifdef ENABLE_FM_RADIO
 			&& gFM_Mode == FM_MODE_OFF
 #endif
@@ -0,0 +1,197 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include "app/radio.h"
+#ifdef ENABLE_FM_RADIO
+	#include "app/fm.h"
+#endif
+#include "driver/bk4819.h"
+#include "driver/uart.h"
+#include "misc.h"
+#include "radio/channels.h"
+#include "radio/detector.h"
+#include "radio/frequencies.h"
+#include "radio/scheduler.h"
+#include "radio/settings.h"
+#include "task/closecall.h"
+
+// The hardware scan takes the receiver away from the VFO, so it only gets
+// a short window every second while the radio is otherwise idle.
+#define CLOSE_CALL_PERIOD	1000
+#define CLOSE_CALL_WINDOW	50
+#define CLOSE_CALL_SETTLE	10
+#define CLOSE_CALL_SIZE		16
+
+enum {
+	STATE_IDLE = 0,
+	STATE_SEARCH,	// The frequency scan is armed on the receiver
+	STATE_SETTLE,	// Tuned to the caught frequency until its level is valid
+};
+
+static CloseCall_t Log[CLOSE_CALL_SIZE];
+static uint32_t LogCount;
+static uint32_t Caught;
+static uint8_t State;
+
+uint8_t gCloseCallMode;
+
+static bool IsRadioIdle(void)
+{
+	return gRadioMode == RADIO_MODE_QUIET
+		&& gScreenMode == SCREEN_MAIN
+		&& !gScannerMode
+		&& !gReceptionMode
+		&& !gMonitorMode
+		&& !gFrequencyDetectMode
+		&& !gSaveMode
+		&& !gDTMF_InputMode
+#ifdef ENABLE_FM_RADIO
+		&& gFM_Mode == FM_MODE_OFF
+#endif
+		;
+}
+
+static void StartSettle(void)
+{
+	uint16_t Result;
+
+	Result = BK4819_ReadRegister(0x0D);
+	BK4819_StopFrequencyScan();
+	if (Result & 0x8000U) {
+		// Nothing locked, the receiver is still on the VFO frequency.
+		return;
+	}
+
+	// The band stays the VFO's, so every way out of the settle only has
+	// to retune.
+	Caught = RADIO_ScanToFrequency(((Result & 0x07FFU) << 16) | BK4819_ReadRegister(0x0E), !gUseUhfFilter);
+
+	// Only long enough on the caught frequency to read its level.
+	BK4819_EnableFilter(true);
+	BK4819_TuneFrequency(Caught);
+	SCHEDULER_StartTimer(TIMER_CLOSE_CALL, CLOSE_CALL_SETTLE);
+	State = STATE_SETTLE;
+}
+
+static void Capture(void)
+{
+	CloseCall_t *pEntry = &Log[LogCount++ % CLOSE_CALL_SIZE];
+
+	pEntry->Frequency = Caught;
+	pEntry->Time = gTimeSinceBoot;
+	pEntry->Rssi = BK4819_GetRSSI();
+
+	if (gCloseCallMode == CLOSE_CALL_TUNE && !gSettings.WorkMode && gVfoState[gSettings.CurrentVfo].RX.Frequency != Caught) {
+		CHANNELS_UpdateVFOFreq(Caught);
+	} else {
+		RADIO_Tune(gSettings.CurrentVfo);
+	}
+}
+
+// A search in flight is checked every tick so it can be cancelled at once.
+bool Task_CloseCallPending(void)
+{
+	return State != STATE_IDLE || (gCloseCallMode != CLOSE_CALL_OFF && !SCHEDULER_IsTimerRunning(TIMER_CLOSE_CALL));
+}
+
+void Task_CloseCall(void)
+{
+	BK4819_TRACE_TAG(BK4819_TAG_SCAN);
+
+	if (!SCHEDULER_CheckTask(TASK_CLOSE_CALL)) {
+		return;
+	}
+
+	SCHEDULER_ClearTask(TASK_CLOSE_CALL);
+
+	if (!Task_CloseCallPending()) {
+		return;
+	}
+
+	if (State != STATE_IDLE && (gCloseCallMode == CLOSE_CALL_OFF || !IsRadioIdle())) {
+		const bool bRetune = State == STATE_SETTLE && gRadioMode == RADIO_MODE_QUIET;
+
+		CLOSECALL_Cancel();
+		if (bRetune) {
+			RADIO_Tune(gSettings.CurrentVfo);
+		}
+		return;
+	}
+
+	if (gCloseCallMode == CLOSE_CALL_OFF || SCHEDULER_IsTimerRunning(TIMER_CLOSE_CALL)) {
+		return;
+	}
+
+	switch (State) {
+	case STATE_IDLE:
+		SCHEDULER_StartTimer(TIMER_CLOSE_CALL, CLOSE_CALL_PERIOD);
+		if (IsRadioIdle()) {
+			BK4819_StartFrequencyScan();
+			SCHEDULER_StartTimer(TIMER_CLOSE_CALL, CLOSE_CALL_WINDOW);
+			State = STATE_SEARCH;
+		}
+		break;
+
+	case STATE_SEARCH:
+		SCHEDULER_StartTimer(TIMER_CLOSE_CALL, CLOSE_CALL_PERIOD);
+		State = STATE_IDLE;
+		StartSettle();
+		break;
+
+	case STATE_SETTLE:
+		SCHEDULER_StartTimer(TIMER_CLOSE_CALL, CLOSE_CALL_PERIOD);
+		State = STATE_IDLE;
+		Capture();
+		break;
+	}
+}
+
+// Anything taking over the receiver calls this before retuning it.
+void CLOSECALL_Cancel(void)
+{
+	if (State == STATE_SEARCH) {
+		BK4819_StopFrequencyScan();
+	}
+	if (State != STATE_IDLE) {
+		State = STATE_IDLE;
+		SCHEDULER_StartTimer(TIMER_CLOSE_CALL, CLOSE_CALL_PERIOD);
+	}
+}
+
+bool CLOSECALL_IsActive(void)
+{
+	return State != STATE_IDLE;
+}
+
+void CLOSECALL_Reset(void)
+{
+	LogCount = 0;
+}
+
+// Sends the retained captures oldest first, then the total number caught so
+// the host can tell how many were overwritten.
+void CLOSECALL_Dump(void)
+{
+	const uint32_t Count = LogCount;
+	uint32_t i;
+
+	i = Count > CLOSE_CALL_SIZE ? Count - CLOSE_CALL_SIZE : 0;
+	for (; i < Count; i++) {
+		UART_SendFrame(0x58, &Log[i % CLOSE_CALL_SIZE], sizeof(CloseCall_t));
+	}
+	UART_SendFrame(0x06, &Count, sizeof(Count));
+}
+
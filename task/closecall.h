@@ -0,0 +1,46 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef TASK_CLOSECALL_H
+#define TASK_CLOSECALL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+enum {
+	CLOSE_CALL_OFF = 0,
+	CLOSE_CALL_LOG,
+	CLOSE_CALL_TUNE,
+	CLOSE_CALL_COUNT,
+};
+
+typedef struct __attribute__((packed)) {
+	uint32_t Frequency;
+	uint32_t Time;		// gTimeSinceBoot when it was caught
+	uint16_t Rssi;
+} CloseCall_t;
+
+extern uint8_t gCloseCallMode;
+
+bool Task_CloseCallPending(void);
+void Task_CloseCall(void);
+void CLOSECALL_Cancel(void);
+bool CLOSECALL_IsActive(void);
+void CLOSECALL_Reset(void);
+void CLOSECALL_Dump(void);
+
+#endif
+
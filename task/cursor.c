@@ -14,20 +14,31 @@
  *     limitations under the License.
  */
 
+#include "radio/scheduler.h"
 #include "task/cursor.h"
 #include "ui/menu.h"
 
 bool gCursorEnabled;
 bool gCursorBlink;
 uint16_t gCursorPosition;
-uint16_t gCursorCountdown;
+
+bool Task_CursorPending(void)
+{
+	return gCursorEnabled && !SCHEDULER_IsTimerRunning(TIMER_CURSOR);
+}
 
 void Task_BlinkCursor(void)
 {
-	if (gCursorEnabled && gCursorCountdown == 0) {
+	if (!SCHEDULER_CheckTask(TASK_CURSOR)) {
+		return;
+	}
+
+	SCHEDULER_ClearTask(TASK_CURSOR);
+
+	if (Task_CursorPending()) {
 		gCursorBlink = !gCursorBlink;
 		UI_DrawCursor(gCursorPosition, gCursorBlink);
-		gCursorCountdown = 500;
+		SCHEDULER_StartTimer(TIMER_CURSOR, 500);
 	}
 }
 
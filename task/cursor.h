@@ -23,8 +23,8 @@
 extern bool gCursorEnabled;
 extern bool gCursorBlink;
 extern uint16_t gCursorPosition;
-extern uint16_t gCursorCountdown;
 
+bool Task_CursorPending(void);
 void Task_BlinkCursor(void);
 
 #endif
@@ -20,13 +20,26 @@
 #include "radio/scheduler.h"
 #include "task/encrypt.h"
 
+// ENCRYPT_Timer only counts while transmitting.
+bool Task_EncryptPending(void)
+{
+	return ENCRYPT_Timer >= 200;
+}
+
 void Task_Encrypt(void)
 {
+	if (!SCHEDULER_CheckTask(TASK_ENCRYPT)) {
+		return;
+	}
+
+	SCHEDULER_ClearTask(TASK_ENCRYPT);
+
+	if (!Task_EncryptPending()) {
+		return;
+	}
+
 	if (gRadioMode == RADIO_MODE_TX) {
 		if (gMainVfo->Encrypt >= 2 && !gMainVfo->bMuteEnabled) {
-			if (ENCRYPT_Timer < 200) {
-				return;
-			}
 			gCode ^= 0x0083;
 			CSS_SetStandardCode(gVfoInfo[gCurrentVfo].CodeType, gCode, gMainVfo->Encrypt, gMainVfo->bIsNarrow);
 		}
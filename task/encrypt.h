@@ -17,6 +17,9 @@
 #ifndef TASK_ENCRYPT_H
 #define TASK_ENCRYPT_H
 
+#include <stdbool.h>
+
+bool Task_EncryptPending(void);
 void Task_Encrypt(void);
 
 #endif
@@ -24,9 +24,14 @@
 #include "task/fmscanner.h"
 #include "ui/helper.h"
 
+bool Task_FmScannerPending(void)
+{
+	return gFM_Mode >= FM_MODE_SCROLL_UP;
+}
+
 void Task_CheckScannerFM(void)
 {
-	if (gFM_Mode < FM_MODE_SCROLL_UP || !SCHEDULER_CheckTask(TASK_FM_SCANNER)) {
+	if (!Task_FmScannerPending() || !SCHEDULER_CheckTask(TASK_FM_SCANNER)) {
 		return;
 	}
 
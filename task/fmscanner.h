@@ -17,6 +17,9 @@
 #ifndef TASK_FM_SCANNER_H
 #define TASK_FM_SCANNER_H
 
+#include <stdbool.h>
+
+bool Task_FmScannerPending(void);
 void Task_CheckScannerFM(void);
 
 #endif
@@ -25,13 +25,24 @@
 #include "task/idle.h"
 #include "task/vox.h"
 
-void Task_Idle(void)
+bool Task_IdlePending(void)
 {
-	if (gRadioMode != RADIO_MODE_RX && gRadioMode != RADIO_MODE_TX && VOX_Counter == 0 && gRxLinkCounter == 0 && !gScannerMode && !gReceptionMode && !gMonitorMode && !gEnableLocalAlarm && gSaveModeTimer == 0 && SPEAKER_State == 0
+	return gRadioMode != RADIO_MODE_RX && gRadioMode != RADIO_MODE_TX && VOX_Counter == 0 && gRxLinkCounter == 0 && !gScannerMode && !gReceptionMode && !gMonitorMode && !gEnableLocalAlarm && !SCHEDULER_IsTimerRunning(TIMER_SAVE_MODE) && SPEAKER_State == 0
 #ifdef ENABLE_FM_RADIO
 		&& gFM_Mode == FM_MODE_OFF
 #endif
-			) {
+		;
+}
+
+void Task_Idle(void)
+{
+	if (!SCHEDULER_CheckTask(TASK_IDLE)) {
+		return;
+	}
+
+	SCHEDULER_ClearTask(TASK_IDLE);
+
+	if (Task_IdlePending()) {
 		switch (gIdleMode) {
 		case IDLE_MODE_OFF:
 #ifdef ENABLE_NOAA
@@ -55,7 +66,7 @@ void Task_Idle(void)
 			} else {
 				gIdleMode = IDLE_MODE_OFF;
 			}
-			gSaveModeTimer = 150;
+			SCHEDULER_StartTimer(TIMER_SAVE_MODE, 150);
 			break;
 
 #ifdef ENABLE_NOAA
@@ -69,7 +80,7 @@ void Task_Idle(void)
 			} else {
 				gIdleMode = IDLE_MODE_OFF;
 			}
-			gSaveModeTimer = 150;
+			SCHEDULER_StartTimer(TIMER_SAVE_MODE, 150);
 			break;
 #endif
 
@@ -78,17 +89,17 @@ void Task_Idle(void)
 			gNoaaMode = false;
 #endif
 			gIdleMode = IDLE_MODE_OFF;
-			if (gIdleTimer == 0) {
+			if (!SCHEDULER_IsTimerRunning(TIMER_IDLE)) {
 				if (gTimeSinceBoot < 600000) {
-					gSaveModeTimer = 160;
+					SCHEDULER_StartTimer(TIMER_SAVE_MODE, 160);
 				} else if (gTimeSinceBoot >= 600000 && gTimeSinceBoot < 1200000) {
-					gSaveModeTimer = 320;
+					SCHEDULER_StartTimer(TIMER_SAVE_MODE, 320);
 				} else if (gTimeSinceBoot >= 1200000 && gTimeSinceBoot < 1800000) {
-					gSaveModeTimer = 480;
+					SCHEDULER_StartTimer(TIMER_SAVE_MODE, 480);
 				} else if (gTimeSinceBoot >= 1800000 && gTimeSinceBoot < 2400000) {
-					gSaveModeTimer = 640;
+					SCHEDULER_StartTimer(TIMER_SAVE_MODE, 640);
 				} else if (gTimeSinceBoot >= 2400000) {
-					gSaveModeTimer = 750;
+					SCHEDULER_StartTimer(TIMER_SAVE_MODE, 750);
 				}
 				RADIO_Sleep();
 			}
@@ -116,6 +127,6 @@ void IDLE_SelectMode(void)
 	} else if (gSettings.SaveMode) {
 		gIdleMode = IDLE_MODE_SAVE;
 	}
-	gSaveModeTimer = 150;
+	SCHEDULER_StartTimer(TIMER_SAVE_MODE, 150);
 }
 
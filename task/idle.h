@@ -17,6 +17,9 @@
 #ifndef TASK_IDLE_H
 #define TASK_IDLE_H
 
+#include <stdbool.h>
+
+bool Task_IdlePending(void);
 void Task_Idle(void);
 void IDLE_SelectMode(void);
 
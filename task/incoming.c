@@ -23,16 +23,33 @@
 #include "misc.h"
 #include "radio/scheduler.h"
 #include "radio/settings.h"
+#ifdef ENABLE_CLOSE_CALL
+	#include "task/closecall.h"
+#endif
 #include "task/incoming.h"
 #include "task/ptt.h"
 
-void Task_CheckIncoming(void)
+bool Task_IncomingPending(void)
 {
-	if (
+#ifdef ENABLE_CLOSE_CALL
+	// The squelch follows the close call search, not the VFO.
+	if (CLOSECALL_IsActive()) {
+		return false;
+	}
+#endif
+
+	return
 #ifdef ENABLE_FM_RADIO
-			(gFM_Mode == FM_MODE_OFF || gSettings.FmStandby) &&
+		(gFM_Mode == FM_MODE_OFF || gSettings.FmStandby) &&
 #endif
-			gRadioMode != RADIO_MODE_TX && !gSaveMode && SCHEDULER_CheckTask(TASK_CHECK_INCOMING) && gIncomingTimer == 0) {
+		gRadioMode != RADIO_MODE_TX && !gSaveMode && !SCHEDULER_IsTimerRunning(TIMER_INCOMING);
+}
+
+void Task_CheckIncoming(void)
+{
+	BK4819_TRACE_TAG(BK4819_TAG_POLL);
+
+	if (SCHEDULER_CheckTask(TASK_CHECK_INCOMING) && Task_IncomingPending()) {
 		bool bGotLink;
 
 		SCHEDULER_ClearTask(TASK_CHECK_INCOMING);
@@ -57,7 +74,7 @@ void Task_CheckIncoming(void)
 		} else {
 			if (gRxLinkCounter++ > 5) {
 				gRxLinkCounter = 0;
-				gSaveModeTimer = 300;
+				SCHEDULER_StartTimer(TIMER_SAVE_MODE, 300);
 				if (gMainVfo->BCL == BUSY_LOCK_CARRIER && !gFrequencyDetectMode) {
 					PTT_SetLock(PTT_LOCK_INCOMING);
 				}
@@ -17,6 +17,9 @@
 #ifndef TASK_INCOMING_H
 #define TASK_INCOMING_H
 
+#include <stdbool.h>
+
+bool Task_IncomingPending(void);
 void Task_CheckIncoming(void);
 
 #endif
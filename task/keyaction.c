@@ -39,6 +39,9 @@
 #include "radio/scheduler.h"
 #include "radio/settings.h"
 #include "task/alarm.h"
+#ifdef ENABLE_CLOSE_CALL
+#include "task/closecall.h"
+#endif
 #include "task/idle.h"
 #include "task/keyaction.h"
 #include "task/keys.h"
@@ -184,7 +187,7 @@ void ACTION_SCAN_fn(void)
 	gManualScanDirection = gSettings.ScanDirection;
 	gScannerMode ^= 1;
 	bBeep740 = gScannerMode;
-	SCANNER_Countdown = 15;
+	SCHEDULER_StartTimer(TIMER_SCANNER, 15);
 	UI_DrawScan();
 }
 
@@ -304,8 +307,8 @@ void ACTION_DTMF_DECODE_fn(void)
 		if (gRadioMode == RADIO_MODE_RX) {
 			return;
 		}
-		if (VOX_Timer) {
-			VOX_Timer = 0;
+		if (SCHEDULER_IsTimerRunning(TIMER_VOX)) {
+			SCHEDULER_StopTimer(TIMER_VOX);
 			Task_UpdateScreen();
 		}
 		DTMF_ResetString();
@@ -329,7 +332,7 @@ void ACTION_DUAL_DISPLAY_fn(void)
 #endif
 	gSettings.DualDisplay ^= 1;
 	SETTINGS_SaveGlobals();
-	VOX_Timer = 0;
+	SCHEDULER_StopTimer(TIMER_VOX);
 	UI_DrawMain(true);
 }
 
@@ -371,6 +374,15 @@ void ACTION_SPECTRUM_fn(void)
 }
 #endif
 
+#ifdef ENABLE_CLOSE_CALL
+// Off, log the captures, log and tune the VFO to them.
+void ACTION_CLOSE_CALL_fn(void)
+{
+	gCloseCallMode = (gCloseCallMode + 1) % CLOSE_CALL_COUNT;
+	bBeep740 = gCloseCallMode != CLOSE_CALL_OFF;
+}
+#endif
+
 void (*action_fn_table[])(void) = {
 	[ACTION_MONITOR] = &ACTION_MONITOR_fn,
 	[ACTION_FREQUENCY_DETECT] = &ACTION_FREQUENCY_DETECT_fn,
@@ -408,6 +420,9 @@ void (*action_fn_table[])(void) = {
 #ifdef ENABLE_SPECTRUM
 	[ACTION_SPECTRUM] = &ACTION_SPECTRUM_fn,
 #endif
+#ifdef ENABLE_CLOSE_CALL
+	[ACTION_CLOSE_CALL] = &ACTION_CLOSE_CALL_fn,
+#endif
 };
 
 void KeypressAction(uint8_t Action)
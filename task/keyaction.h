@@ -46,6 +46,7 @@ enum {
 	ACTION_LOCK,
 	ACTION_SPECTRUM,
 	ACTION_DARK_MODE,
+	ACTION_CLOSE_CALL,
 	ACTIONS_COUNT,	// used to count the number of actions, keep this last
 };
 
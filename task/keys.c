@@ -92,7 +92,7 @@ static void MAIN_KeyHandler(KEY_t Key)
 {
 	uint8_t Vfo = 1;
 
-	VOX_Timer = 0;
+	SCHEDULER_StopTimer(TIMER_VOX);
 	Task_UpdateScreen();
 	if (gScannerMode && Key != KEY_UP && Key != KEY_DOWN) {
 		SETTINGS_SaveState();
@@ -179,7 +179,7 @@ static void MAIN_KeyHandler(KEY_t Key)
 #ifdef ENABLE_NOAA
 				} else {
 					CHANNELS_NextNOAA(Key);
-					NOAA_NextChannelCountdown = 3000;
+					SCHEDULER_StartTimer(TIMER_NOAA, 3000);
 #endif
 				}
 #ifdef ENABLE_FM_RADIO
@@ -315,6 +315,8 @@ static void HandlerShort(KEY_t Key)
 	case SCREEN_SETTING:
 		MENU_SettingKeyHandler(Key);
 		break;
+	default:
+		break;
 	}
 }
 
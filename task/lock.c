@@ -17,6 +17,7 @@
 #include "app/lock.h"
 #include "helper/helper.h"
 #include "misc.h"
+#include "radio/scheduler.h"
 #include "radio/settings.h"
 #include "task/lock.h"
 
@@ -26,6 +27,12 @@ void Task_CheckLockScreen(void)
 {
 	uint16_t Timer;
 
+	if (!SCHEDULER_CheckTask(TASK_LOCK)) {
+		return;
+	}
+
+	SCHEDULER_ClearTask(TASK_LOCK);
+
 	Timer = TIMER_Calculate(gSettings.LockTimer);
 	if (gSettings.LockTimer == 0 || gSettings.Lock || gScreenMode != SCREEN_MAIN || gEnableLocalAlarm || gScannerMode || gDTMF_InputMode || gSettings.DtmfState != DTMF_STATE_NORMAL || gReceptionMode) {
 		gLockTimer = 0;
@@ -16,15 +16,25 @@
 
 #include "misc.h"
 #include "radio/channels.h"
+#include "radio/scheduler.h"
 #include "task/noaa.h"
 
-uint16_t NOAA_NextChannelCountdown;
+bool Task_NoaaPending(void)
+{
+	return gReceptionMode && !gReceivingAudio && !SCHEDULER_IsTimerRunning(TIMER_NOAA);
+}
 
 void Task_CheckNOAA(void)
 {
-	if (gReceptionMode && !gReceivingAudio && NOAA_NextChannelCountdown == 0) {
+	if (!SCHEDULER_CheckTask(TASK_NOAA)) {
+		return;
+	}
+
+	SCHEDULER_ClearTask(TASK_NOAA);
+
+	if (Task_NoaaPending()) {
 		CHANNELS_NextNOAA(11);
-		NOAA_NextChannelCountdown = 300;
+		SCHEDULER_StartTimer(TIMER_NOAA, 300);
 	}
 }
 
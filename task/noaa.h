@@ -17,10 +17,10 @@
 #ifndef TASK_NOAA_H
 #define TASK_NOAA_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
-extern uint16_t NOAA_NextChannelCountdown;
-
+bool Task_NoaaPending(void);
 void Task_CheckNOAA(void);
 
 #endif
@@ -105,7 +105,7 @@ void Task_CheckPTT(void)
 			if (gPttPressed) {
 				BEEP_Play(440, 4, 80);
 				return;
-			} else if (gRadioMode == RADIO_MODE_TX) {
+			} else if (gRadioMode == RADIO_MODE_TX && !RADIO_IsEndingTX()) {
 				VOX_Update();
 				if (Timer && (gPttTimeout / 1000) >= Timer) {
 					PTT_SetLock(PTT_LOCK_VOX);
@@ -39,7 +39,7 @@ static uint8_t GetToneStatus(uint8_t CodeType, bool bMuteEnabled)
 {
 	uint16_t Value;
 	
-	Value = BK4819_ReadRegister(0x0C);
+	Value = BK4819_GetStatus();
 
 #ifdef ENABLE_NOAA
 	if (gNoaaMode) {
@@ -49,9 +49,9 @@ static uint8_t GetToneStatus(uint8_t CodeType, bool bMuteEnabled)
 #endif
 
 	// Check Interrupt Request
-	if (Value & 0x0001U && gRadioMode == RADIO_MODE_RX) {
+	if (Value & BK4819_REG_0C_INTERRUPT && gRadioMode == RADIO_MODE_RX) {
 		DATA_ReceiverCheck();
-		Value = BK4819_ReadRegister(0x0C);
+		Value = BK4819_GetStatus();
 	}
 
 	if (gMonitorMode) {
@@ -92,11 +92,11 @@ static uint8_t GetToneStatus(uint8_t CodeType, bool bMuteEnabled)
 
 static void CheckRSSI(void)
 {
-	if (gVoxRssiUpdateTimer == 0 && !gDataDisplay && !gDTMF_InputMode && !gFrequencyDetectMode && !gReceptionMode && !gFskDataReceived && gScreenMode == SCREEN_MAIN) {
+	if (!SCHEDULER_IsTimerRunning(TIMER_VOX_RSSI) && !gDataDisplay && !gDTMF_InputMode && !gFrequencyDetectMode && !gReceptionMode && !gFskDataReceived && gScreenMode == SCREEN_MAIN) {
 		uint16_t RSSI;
 		uint16_t Power;
 
-		gVoxRssiUpdateTimer = 100;
+		SCHEDULER_StartTimer(TIMER_VOX_RSSI, 100);
 		RSSI = BK4819_GetRSSI();
 
 		//Valid range is 72 - 330
@@ -115,9 +115,16 @@ static void CheckRSSI(void)
 	}
 }
 
+bool Task_RssiPending(void)
+{
+	return gRadioMode != RADIO_MODE_TX && gRadioMode != RADIO_MODE_QUIET && !gSaveMode;
+}
+
 void Task_CheckRSSI(void)
 {
-	if (gRadioMode != RADIO_MODE_TX && gRadioMode != RADIO_MODE_QUIET && !gSaveMode && SCHEDULER_CheckTask(TASK_CHECK_RSSI)) {
+	BK4819_TRACE_TAG(BK4819_TAG_POLL);
+
+	if (SCHEDULER_CheckTask(TASK_CHECK_RSSI) && Task_RssiPending()) {
 		uint8_t Status;
 
 		SCHEDULER_ClearTask(TASK_CHECK_RSSI);
@@ -17,6 +17,9 @@
 #ifndef TASK_RSSI_H
 #define TASK_RSSI_H
 
+#include <stdbool.h>
+
+bool Task_RssiPending(void);
 void Task_CheckRSSI(void);
 
 #endif
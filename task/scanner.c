@@ -25,15 +25,14 @@
 #include "task/scanner.h"
 #include "ui/helper.h"
 
-uint16_t SCANNER_Countdown;
+bool Task_ScannerPending(void) {
+	return gRadioMode < (gExtendedSettings.ScanResume == 2 ? RADIO_MODE_TX : RADIO_MODE_RX) 	// Allows Task_Scanner in RX mode if ScanResume is set to Time Operated
+		&& gScannerMode
+		&& !SCHEDULER_IsTimerRunning(TIMER_SCANNER);
+}
 
 void Task_Scanner(void) {
-	if ((gRadioMode < (gExtendedSettings.ScanResume == 2 ? RADIO_MODE_TX : RADIO_MODE_RX) 	// Allows Task_Scanner in RX mode if ScanResume is set to Time Operated
-			&& gScannerMode
-			&& SCANNER_Countdown == 0
-			&& SCHEDULER_CheckTask(TASK_SCANNER)
-			)
-			|| gForceScan) {
+	if ((SCHEDULER_CheckTask(TASK_SCANNER) && Task_ScannerPending()) || gForceScan) {
 		SCHEDULER_ClearTask(TASK_SCANNER);
 		gForceScan = false;
 		if (gRadioMode == RADIO_MODE_RX) {	// Scanner timeout
@@ -45,9 +44,13 @@ void Task_Scanner(void) {
 			}
 		} else {
 			CHANNELS_NextChannelVfo(gManualScanDirection ? KEY_DOWN : KEY_UP);
-			RADIO_Tune(gSettings.CurrentVfo);
+			if (gSettings.RepeaterMode == 0 && gCurrentVfo == gSettings.CurrentVfo && !gNoaaMode) {
+				RADIO_FastTune(gMainVfo->RX.Frequency);
+			} else {
+				RADIO_Tune(gSettings.CurrentVfo);
+			}
 		}
-		SCANNER_Countdown = 15;
+		SCHEDULER_StartTimer(TIMER_SCANNER, 15);
 		if (gExtendedSettings.ScanBlink) {
 			gpio_bits_flip(GPIOA, BOARD_GPIOA_LED_GREEN);
 		}
@@ -17,10 +17,10 @@
 #ifndef TASK_SCANNER_H
 #define TASK_SCANNER_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
-extern uint16_t SCANNER_Countdown;
-
+bool Task_ScannerPending(void);
 void Task_Scanner(void);
 void Next_ScanList(void);
 
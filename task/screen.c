@@ -23,9 +23,16 @@
 #include "task/screen.h"
 #include "ui/main.h"
 
+bool Task_ScreenPending(void)
+{
+	return gRedrawScreen && !SCHEDULER_IsTimerRunning(TIMER_VOX);
+}
+
+// Also called straight after drawing, so it does not wait for its bit.
 void Task_UpdateScreen(void)
 {
-	if (VOX_Timer == 0 && gRedrawScreen) {
+	SCHEDULER_ClearTask(TASK_UPDATE_SCREEN);
+	if (Task_ScreenPending()) {
 		gRedrawScreen = false;
 		if (!DATA_WasDataReceived()) {
 			if (gScreenMode == SCREEN_MAIN && !gReceptionMode) {
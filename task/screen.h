@@ -17,6 +17,9 @@
 #ifndef TASK_SCREEN_H
 #define TASK_SCREEN_H
 
+#include <stdbool.h>
+
+bool Task_ScreenPending(void);
 void Task_UpdateScreen(void);
 
 #endif
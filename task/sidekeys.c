@@ -70,15 +70,12 @@ void Task_CheckSideKeys(void)
 	if (gSettings.bEnableDisplay && gEnableBlink) {
 		SCREEN_TurnOn();
 		BEEP_Play(740, 2, 100);
-		return;
-	}
-
-	if (Action == ACTION_NONE) {
-		return;
+	} else if (Action != ACTION_NONE) {
+		SCREEN_TurnOn();
+		KeypressAction(Action);
 	}
 
-	SCREEN_TurnOn();
-
-	KeypressAction(Action);
+	// Key pad actions read gSlot as well and must not see a side key slot.
+	gSlot = 6;
 }
 
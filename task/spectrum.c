@@ -0,0 +1,54 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include "app/spectrum.h"
+#include "driver/bk4819.h"
+#include "misc.h"
+#include "radio/scheduler.h"
+#include "task/spectrum.h"
+
+// Caps the bins measured per pass when the scan delay is 0.
+#define SPECTRUM_BINS_PER_TASK 4
+
+// Bins settle on TIMER_SPECTRUM, nothing to measure until it runs out.
+bool Task_SpectrumPending(void)
+{
+	return gScreenMode == SCREEN_SPECTRUM && !SCHEDULER_IsTimerRunning(TIMER_SPECTRUM);
+}
+
+void Task_Spectrum(void)
+{
+	uint8_t i;
+
+	BK4819_TRACE_TAG(BK4819_TAG_SPECTRUM);
+
+	if (!SCHEDULER_CheckTask(TASK_SPECTRUM)) {
+		return;
+	}
+
+	SCHEDULER_ClearTask(TASK_SPECTRUM);
+
+	if (!Task_SpectrumPending()) {
+		return;
+	}
+
+	for (i = 0; i < SPECTRUM_BINS_PER_TASK; i++) {
+		if (!SPECTRUM_Step()) {
+			break;
+		}
+	}
+}
+
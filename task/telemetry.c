@@ -0,0 +1,91 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include "app/radio.h"
+#include "app/uart.h"
+#include "driver/battery.h"
+#include "driver/bk4819.h"
+#include "driver/uart.h"
+#include "misc.h"
+#include "radio/scheduler.h"
+#ifdef ENABLE_AM_FIX
+	#include "task/am-fix.h"
+#endif
+#include "task/telemetry.h"
+
+// One fixed size record every 64 ms, little endian, sum of all previous bytes at the end.
+typedef struct __attribute__((packed)) {
+	uint8_t Sync[2];
+	uint8_t Sequence;
+	uint32_t Time;
+	uint32_t Frequency;
+	uint16_t RSSI;
+	uint8_t Noise;
+	uint8_t Glitch;
+	uint8_t AmFixIndex;
+	uint8_t RadioMode;
+	uint8_t Flags;
+	uint8_t Battery;
+	uint8_t Sum;
+} TelemetryFrame_t;
+
+static TelemetryFrame_t Frame = {
+	.Sync = { 0xAB, 0xCD },
+};
+
+uint16_t gTelemetryDropped;
+
+void Task_Telemetry(void)
+{
+	const uint8_t *pBytes = (const uint8_t *)&Frame;
+	uint8_t Sum = 0;
+	uint8_t i;
+
+	if (!SCHEDULER_CheckTask(TASK_TELEMETRY)) {
+		return;
+	}
+
+	SCHEDULER_ClearTask(TASK_TELEMETRY);
+
+	if (UART_IsRunning) {
+		return;
+	}
+
+	Frame.Sequence++;
+	Frame.Time = gTimeSinceBoot;
+	Frame.Frequency = gVfoInfo[gCurrentVfo].Frequency;
+	Frame.RSSI = BK4819_GetRSSI();
+	Frame.Noise = BK4819_GetNoise();
+	Frame.Glitch = BK4819_GetGlitch();
+#ifdef ENABLE_AM_FIX
+	Frame.AmFixIndex = gain_table_index[gCurrentVfo];
+#else
+	Frame.AmFixIndex = 0xFF;
+#endif
+	Frame.RadioMode = gRadioMode;
+	Frame.Flags = (BK4819_CheckSquelchLink() << 0) | (gSaveMode << 1) | (gMonitorMode << 2);
+	Frame.Battery = gBatteryVoltage;
+
+	for (i = 0; i < sizeof(Frame) - 1; i++) {
+		Sum += pBytes[i];
+	}
+	Frame.Sum = Sum;
+
+	if (!UART_Queue(&Frame, sizeof(Frame))) {
+		gTelemetryDropped++;
+	}
+}
+
@@ -21,10 +21,22 @@
 #include "radio/settings.h"
 #include "task/timeout.h"
 
+// The green LED blinks every 5 s while the display is off, lit for 200 ms.
+bool Task_BlinkPending(void)
+{
+	return (gEnableBlink || !gSettings.bEnableDisplay) && (STANDBY_Counter > 5000 || (gBlinkGreen && gGreenLedTimer > 199));
+}
+
 void Task_CheckDisplayTimeout(void)
 {
 	const uint16_t Timer = TIMER_Calculate(gSettings.DisplayTimer);
 
+	if (!SCHEDULER_CheckTask(TASK_DISPLAY_TIMEOUT)) {
+		return;
+	}
+
+	SCHEDULER_ClearTask(TASK_DISPLAY_TIMEOUT);
+
 	if (!gSettings.bEnableDisplay) {
 		STANDBY_BlinkGreen();
 		return;
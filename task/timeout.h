@@ -17,6 +17,9 @@
 #ifndef TASK_TIMEOUT_H
 #define TASK_TIMEOUT_H
 
+#include <stdbool.h>
+
+bool Task_BlinkPending(void);
 void Task_CheckDisplayTimeout(void);
 
 #endif
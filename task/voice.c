@@ -18,24 +18,38 @@
 #include "driver/pwm.h"
 #include "driver/speaker.h"
 #include "misc.h"
+#include "radio/scheduler.h"
 #include "radio/settings.h"
 #include "task/voice.h"
 
+// A prompt sample is queued, or the last one has finished and still holds
+// the speaker.
+bool Task_VoicePending(void)
+{
+	return gSettings.VoicePrompt && !gAudioPlaying && (SPEAKER_State & SPEAKER_OWNER_SYSTEM) == 0 && (gAudioOffsetIndex < gAudioOffsetLast || (SPEAKER_State & SPEAKER_OWNER_VOICE));
+}
+
 void Task_VoicePlayer(void)
 {
 	uint8_t Index;
 
-	if (gSettings.VoicePrompt && !gAudioPlaying && (SPEAKER_State & SPEAKER_OWNER_SYSTEM) == 0) {
+	if (!SCHEDULER_CheckTask(TASK_VOICE)) {
+		return;
+	}
+
+	SCHEDULER_ClearTask(TASK_VOICE);
+
+	if (Task_VoicePending()) {
 		Index = gAudioOffsetIndex;
 		if (Index < gAudioOffsetLast) {
 			if (SFLASH_Offsets[Index] < 0x188000) {
-				gAudioTimer = 700;
+				SCHEDULER_StartTimer(TIMER_AUDIO, 700);
 			} else {
-				gAudioTimer = 900;
+				SCHEDULER_StartTimer(TIMER_AUDIO, 900);
 			}
 			gAudioOffsetIndex++;
 			AUDIO_PlaySample(9375, SFLASH_Offsets[Index]);
-		} else if (SPEAKER_State & SPEAKER_OWNER_VOICE) {
+		} else {
 			SPEAKER_TurnOff(SPEAKER_OWNER_VOICE);
 			PWM_Reset();
 		}
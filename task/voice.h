@@ -17,6 +17,9 @@
 #ifndef TASK_VOICE_H
 #define TASK_VOICE_H
 
+#include <stdbool.h>
+
+bool Task_VoicePending(void);
 void Task_VoicePlayer(void);
 
 #endif
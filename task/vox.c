@@ -39,7 +39,6 @@ static const uint16_t gVoxTable[10] = {
 	0x0104,
 };
 
-uint16_t gVoxRssiUpdateTimer;
 uint16_t VOX_Counter;
 bool VOX_IsTransmitting;
 
@@ -62,10 +61,10 @@ static bool CheckStatus(void)
 
 void VOX_Update(void)
 {
-	if (gVoxRssiUpdateTimer == 0) {
+	if (!SCHEDULER_IsTimerRunning(TIMER_VOX_RSSI)) {
 		uint16_t Vox;
 
-		gVoxRssiUpdateTimer = 100;
+		SCHEDULER_StartTimer(TIMER_VOX_RSSI, 100);
 		Vox = BK4819_ReadRegister(0x64);
 		if (Vox > 5000) {
 			Vox = 5000;
@@ -74,42 +73,45 @@ void VOX_Update(void)
 	}
 }
 
-void Task_VoxUpdate(void)
+bool Task_VoxPending(void)
 {
-	if (gSettings.Vox && gPttLock == 0 && !gSaveMode && gScreenMode == SCREEN_MAIN && VOX_Timer == 0) {
-		if (SCHEDULER_CheckTask(TASK_VOX)
+	return gSettings.Vox && gPttLock == 0 && !gSaveMode && gScreenMode == SCREEN_MAIN && !SCHEDULER_IsTimerRunning(TIMER_VOX)
 #ifdef ENABLE_FM_RADIO
-			&& gFM_Mode == FM_MODE_OFF
+		&& gFM_Mode == FM_MODE_OFF
 #endif
-			&& !gDTMF_InputMode) {
-			bool bFlag;
+		&& !gDTMF_InputMode;
+}
+
+void Task_VoxUpdate(void)
+{
+	if (SCHEDULER_CheckTask(TASK_VOX) && Task_VoxPending()) {
+		bool bFlag;
 
-			SCHEDULER_ClearTask(TASK_VOX);
+		SCHEDULER_ClearTask(TASK_VOX);
 
-			bFlag = CheckStatus();
-			if (!bFlag || gRadioMode != RADIO_MODE_QUIET) {
-				if (!bFlag && gRadioMode == RADIO_MODE_TX) {
-					uint16_t Delay;
+		bFlag = CheckStatus();
+		if (!bFlag || gRadioMode != RADIO_MODE_QUIET) {
+			if (!bFlag && gRadioMode == RADIO_MODE_TX) {
+				uint16_t Delay;
 
-					Delay = VOX_Counter++ / 64;
-					if (Delay >= gSettings.VoxDelay) {
-						VOX_IsTransmitting = false;
-						VOX_Counter = 0;
-						RADIO_EndTX();
-					}
-					VOX_Update();
-				} else {
-					if (VOX_IsTransmitting) {
-						VOX_Update();
-					}
+				Delay = VOX_Counter++ / 64;
+				if (Delay >= gSettings.VoxDelay) {
+					VOX_IsTransmitting = false;
 					VOX_Counter = 0;
+					RADIO_EndTX();
 				}
+				VOX_Update();
 			} else {
-				if (VOX_Counter++ > 4) {
-					VOX_IsTransmitting = true;
-					SCREEN_TurnOn();
-					RADIO_StartTX(true);
+				if (VOX_IsTransmitting) {
+					VOX_Update();
 				}
+				VOX_Counter = 0;
+			}
+		} else {
+			if (VOX_Counter++ > 4) {
+				VOX_IsTransmitting = true;
+				SCREEN_TurnOn();
+				RADIO_StartTX(true);
 			}
 		}
 	}
@@ -0,0 +1,41 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+// The battery ADC of driver/battery.c. Calibration is over by the next look
+// at the registers, and a software triggered conversion by the one after,
+// its result going straight to where the DMA channel points.
+
+#include "adc.h"
+
+// Filled by the DMA channel on the radio, defined in driver/battery.c.
+extern volatile uint16_t gBatteryAdcValue;
+
+uint16_t HOST_AdcBattery = HOST_ADC_BATTERY_DEFAULT;
+
+adc_type *HOST_ReadAdc(void)
+{
+	HOST_ADC1.ctrl2_bit.adcalinit = FALSE;
+	HOST_ADC1.ctrl2_bit.adcal = FALSE;
+	if (HOST_ADC1.ctrl2_bit.ocswtrg && HOST_ADC1.ctrl2_bit.adcen) {
+		HOST_ADC1.ctrl2_bit.ocswtrg = FALSE;
+		HOST_ADC1.odt = HOST_AdcBattery;
+		if (HOST_ADC1.ctrl2_bit.ocdmaen && HOST_DMA1_CHANNEL1.ctrl_bit.chen) {
+			gBatteryAdcValue = HOST_AdcBattery;
+		}
+	}
+
+	return &HOST_ADC1;
+}
@@ -0,0 +1,28 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef TESTS_HOST_ADC_H
+#define TESTS_HOST_ADC_H
+
+#include <stdint.h>
+
+// What the ADC reads on the battery divider, 4 / 66 of it in 0.1 V. The
+// default is an 8.0 V pack.
+#define HOST_ADC_BATTERY_DEFAULT	1320U
+
+extern uint16_t HOST_AdcBattery;
+
+#endif
@@ -0,0 +1,360 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+// Replaces driver/bk4819-bus.c with a model of the register file. Registers
+// hold what was written, except for the status and result registers, which
+// are worked out from the signals on the air when they are read:
+//
+//   0x0C  squelch link from 0x78 and 0x4F, CTC1 against 0x07, CTC2 for a
+//         55 Hz tail tone, DCS against the code word written to 0x08
+//   0x0D  frequency scan started by bit 0 of 0x32, with 0x0E
+//   0x63  glitch, 0x65 noise and 0x67 RSSI of the strongest signal heard
+//   0x68  CTCSS tone found, 0x69 and 0x6A DCS code word found
+//
+// The crystal is taken as ideal, 0x38 and 0x39 are the frequency heard.
+
+#include <string.h>
+#include "bk4819.h"
+#include "clock.h"
+#include "driver/bk4819-bus.h"
+
+#define LOG_SIZE	65536U
+
+// CTC1 counts as found this close to the tone set in 0x07.
+#define CTCSS_TOLERANCE	2U
+
+HOST_BK4819Stats_t HOST_BK4819Stats;
+
+static uint16_t Registers[128];
+static const HOST_BK4819Signal_t *pSignals;
+static size_t SignalCount;
+static bool bSquelchOpen;
+static uint64_t ScanStart;
+static uint32_t ScanResult;
+static uint32_t DcsWord;
+
+static HOST_BK4819Access_t Log[LOG_SIZE];
+static size_t LogCount;
+
+static uint32_t Distance(uint32_t A, uint32_t B)
+{
+	return A > B ? A - B : B - A;
+}
+
+static int32_t Clamp(int32_t Value, int32_t Min, int32_t Max)
+{
+	if (Value < Min) {
+		return Min;
+	}
+	if (Value > Max) {
+		return Max;
+	}
+
+	return Value;
+}
+
+static void PowerOn(void)
+{
+	memset(Registers, 0, sizeof(Registers));
+	bSquelchOpen = false;
+	ScanResult = 0;
+	DcsWord = 0;
+}
+
+// The strongest signal within its bandwidth of Frequency, or NULL.
+static const HOST_BK4819Signal_t *Strongest(uint32_t Frequency, bool bAnywhere)
+{
+	const HOST_BK4819Signal_t *pBest = NULL;
+	size_t i;
+
+	for (i = 0; i < SignalCount; i++) {
+		const HOST_BK4819Signal_t *pSignal = &pSignals[i];
+		const uint32_t Bandwidth = pSignal->Bandwidth ? pSignal->Bandwidth : 1250U;
+
+		if (!bAnywhere && Distance(pSignal->Frequency, Frequency) > Bandwidth) {
+			continue;
+		}
+		if (!pBest || pSignal->Level > pBest->Level) {
+			pBest = pSignal;
+		}
+	}
+
+	return pBest;
+}
+
+static const HOST_BK4819Signal_t *Heard(void)
+{
+	return Strongest(HOST_BK4819Frequency(), false);
+}
+
+static int16_t Level(void)
+{
+	const HOST_BK4819Signal_t *pSignal = Heard();
+
+	if (!pSignal || pSignal->Level < HOST_BK4819_NOISE_FLOOR) {
+		return HOST_BK4819_NOISE_FLOOR;
+	}
+
+	return pSignal->Level;
+}
+
+// 0.5 dB steps from -160 dBm.
+static uint16_t Rssi(void)
+{
+	return Clamp((Level() + 160) * 2, 0, 0x1FF);
+}
+
+// Both fall by 2 per dB as the signal rises out of the noise.
+static uint16_t Noise(void)
+{
+	return Clamp(70 - ((Level() + 125) * 2), 2, 0x7F);
+}
+
+static uint16_t Glitch(void)
+{
+	return Clamp(40 - ((Level() + 125) * 2), 0, 0xFF);
+}
+
+// Opens on the RSSI and noise open thresholds, closes on either close one.
+static void UpdateSquelch(void)
+{
+	const uint16_t RssiValue = Rssi();
+	const uint16_t NoiseValue = Noise();
+
+	if (bSquelchOpen) {
+		if (RssiValue < (Registers[0x78] & 0xFFU) || NoiseValue > ((Registers[0x4F] >> 8) & 0x7FU)) {
+			bSquelchOpen = false;
+		}
+	} else if (RssiValue >= (Registers[0x78] >> 8) && NoiseValue <= (Registers[0x4F] & 0x7FU)) {
+		bSquelchOpen = true;
+	}
+}
+
+static uint16_t Status(void)
+{
+	const HOST_BK4819Signal_t *pSignal = Heard();
+	uint16_t Value = 0;
+
+	UpdateSquelch();
+	if (Registers[0x02]) {
+		Value |= 0x0001U;
+	}
+	if (bSquelchOpen) {
+		Value |= 0x0002U;
+	}
+	if (!pSignal) {
+		return Value;
+	}
+	if (pSignal->Ctcss && Distance((pSignal->Ctcss * 413U) / 200U, Registers[0x07] & 0x1FFFU) <= CTCSS_TOLERANCE) {
+		Value |= 0x0400U;
+	}
+	if (pSignal->bTailTone) {
+		Value |= 0x0800U;
+	}
+	if (pSignal->Golay && DcsWord) {
+		if ((pSignal->Golay & 0x7FFFFFU) == (DcsWord & 0x7FFFFFU)) {
+			Value |= 0x4000U;
+		} else if ((~pSignal->Golay & 0x7FFFFFU) == (DcsWord & 0x7FFFFFU)) {
+			Value |= 0x8000U;
+		}
+	}
+
+	return Value;
+}
+
+// The counter sees the carrier through the filter picked with the GPIO bits
+// of 0x33, the way RADIO_ConvertScanFrequency() undoes it: halved through
+// the UHF filter, doubled above 240 MHz through the VHF one, and 400 Hz low.
+static uint32_t CountedFrequency(uint32_t Frequency)
+{
+	Frequency -= 40U;
+	if ((Registers[0x33] & 0x0060U) == 0x0020U) {
+		return Frequency > 24000000U ? Frequency * 2U : Frequency;
+	}
+
+	return Frequency < 48000000U ? Frequency / 2U : Frequency;
+}
+
+// Bit 15 stays set until the scan has run long enough and found a carrier.
+static uint16_t ScanStatus(void)
+{
+	const HOST_BK4819Signal_t *pSignal = Strongest(0, true);
+
+	if (!(Registers[0x32] & 1U) || HOST_Time - ScanStart < HOST_BK4819_SCAN_NS || !pSignal || pSignal->Level < HOST_BK4819_SCAN_LEVEL) {
+		return 0x8000U;
+	}
+	ScanResult = CountedFrequency(pSignal->Frequency);
+
+	return (ScanResult >> 16) & 0x07FFU;
+}
+
+static uint16_t CtcssResult(void)
+{
+	const HOST_BK4819Signal_t *pSignal = Heard();
+
+	if (!pSignal || !pSignal->Ctcss) {
+		return 0x8000U;
+	}
+
+	return ((pSignal->Ctcss * 412U) / 200U) & 0x0FFFU;
+}
+
+static uint16_t DcsResult(bool bHigh)
+{
+	const HOST_BK4819Signal_t *pSignal = Heard();
+
+	if (!pSignal || !pSignal->Golay) {
+		return bHigh ? 0x8000U : 0x0000U;
+	}
+	if (bHigh) {
+		return (pSignal->Golay >> 12) & 0x0FFFU;
+	}
+
+	return pSignal->Golay & 0x0FFFU;
+}
+
+static uint16_t Read(uint8_t Reg)
+{
+	switch (Reg) {
+	case 0x0C: return Status();
+	case 0x0D: return ScanStatus();
+	case 0x0E: return ScanResult & 0xFFFFU;
+	case 0x63: return Glitch();
+	case 0x65: return Noise();
+	case 0x67: return Rssi();
+	case 0x68: return CtcssResult();
+	case 0x69: return DcsResult(true);
+	case 0x6A: return DcsResult(false);
+	default:   return Registers[Reg];
+	}
+}
+
+// Each access ends on an interrupt boundary, so loops that only poll the
+// chip still see the ticks fall due.
+static void Record(uint8_t Reg, uint16_t Data, bool bWrite)
+{
+	HOST_Spend(HOST_BK4819_ACCESS_NS);
+	if (bWrite) {
+		HOST_BK4819Stats.Writes++;
+		HOST_BK4819Stats.RegWrites[Reg]++;
+	} else {
+		HOST_BK4819Stats.Reads++;
+		HOST_BK4819Stats.RegReads[Reg]++;
+	}
+	if (LogCount < LOG_SIZE) {
+		Log[LogCount].Time = HOST_Time;
+		Log[LogCount].Data = Data;
+		Log[LogCount].Reg = Reg;
+		Log[LogCount].bWrite = bWrite;
+		LogCount++;
+	} else {
+		HOST_BK4819Stats.Dropped++;
+	}
+	HOST_DeliverPending();
+}
+
+void BK4819_BusInit(void)
+{
+	PowerOn();
+}
+
+uint16_t BK4819_BusRead(uint8_t Reg)
+{
+	const uint16_t Data = Read(Reg & 0x7FU);
+
+	Record(Reg & 0x7FU, Data, false);
+
+	return Data;
+}
+
+void BK4819_BusWrite(uint8_t Reg, uint16_t Data)
+{
+	Reg &= 0x7FU;
+	Record(Reg, Data, true);
+
+	switch (Reg) {
+	case 0x00:
+		if (Data & 0x8000U) {
+			PowerOn();
+			return;
+		}
+		break;
+	case 0x08:
+		// Bit 15 picks the half of the 24-bit code word.
+		if (Data & 0x8000U) {
+			DcsWord = (DcsWord & 0x000FFFU) | ((Data & 0x0FFFU) << 12);
+		} else {
+			DcsWord = (DcsWord & 0xFFF000U) | (Data & 0x0FFFU);
+		}
+		break;
+	case 0x32:
+		if ((Data & 1U) && !(Registers[0x32] & 1U)) {
+			ScanStart = HOST_Time;
+		}
+		break;
+	}
+	Registers[Reg] = Data;
+}
+
+void HOST_BK4819Reset(void)
+{
+	PowerOn();
+	pSignals = NULL;
+	SignalCount = 0;
+	HOST_BK4819ClearLog();
+}
+
+void HOST_BK4819SetSignals(const HOST_BK4819Signal_t *pNewSignals, size_t Count)
+{
+	pSignals = pNewSignals;
+	SignalCount = Count;
+}
+
+void HOST_BK4819RaiseInterrupt(uint16_t Flags)
+{
+	Registers[0x02] |= Flags;
+}
+
+uint16_t HOST_BK4819Peek(uint8_t Reg)
+{
+	const bool bSquelchWasOpen = bSquelchOpen;
+	const uint32_t LastResult = ScanResult;
+	const uint16_t Data = Read(Reg & 0x7FU);
+
+	// Looking must not move the squelch or latch a scan result.
+	bSquelchOpen = bSquelchWasOpen;
+	ScanResult = LastResult;
+
+	return Data;
+}
+
+uint32_t HOST_BK4819Frequency(void)
+{
+	return ((uint32_t)Registers[0x39] << 16) | Registers[0x38];
+}
+
+const HOST_BK4819Access_t *HOST_BK4819Log(size_t *pCount)
+{
+	*pCount = LogCount;
+
+	return Log;
+}
+
+void HOST_BK4819ClearLog(void)
+{
+	LogCount = 0;
+	memset(&HOST_BK4819Stats, 0, sizeof(HOST_BK4819Stats));
+}
@@ -0,0 +1,85 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef TESTS_HOST_BK4819_H
+#define TESTS_HOST_BK4819_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// One register transfer on the 3-wire bus at BK4819_SCL_HZ: 8 address and
+// 16 data clocks plus start and stop.
+#ifndef BK4819_SCL_HZ
+	#define BK4819_SCL_HZ 1000000U
+#endif
+#define HOST_BK4819_ACCESS_NS	((26ULL * 1000000000ULL) / BK4819_SCL_HZ)
+
+// How long the frequency scan of 0x32 takes to lock onto a carrier.
+#define HOST_BK4819_SCAN_NS	150000000ULL
+// Weakest carrier the frequency scan locks onto, in dBm.
+#define HOST_BK4819_SCAN_LEVEL	(-100)
+// What the receiver hears with no signal in its passband, in dBm.
+#define HOST_BK4819_NOISE_FLOOR	(-130)
+
+// A transmitter on the air. Frequencies are in 10 Hz units like the
+// firmware's, tones in 0.1 Hz.
+typedef struct {
+	uint32_t Frequency;
+	int16_t Level;
+	// Half the width within which the receiver hears it, 0 for 12.5 kHz.
+	uint16_t Bandwidth;
+	uint16_t Ctcss;
+	// 23-bit DCS code word as sent, 0 for none.
+	uint32_t Golay;
+	bool bTailTone;
+} HOST_BK4819Signal_t;
+
+typedef struct {
+	uint64_t Time;
+	uint16_t Data;
+	uint8_t Reg;
+	bool bWrite;
+} HOST_BK4819Access_t;
+
+typedef struct {
+	uint32_t Reads;
+	uint32_t Writes;
+	uint32_t RegReads[128];
+	uint32_t RegWrites[128];
+	// Accesses past the end of the log, still counted above.
+	uint32_t Dropped;
+} HOST_BK4819Stats_t;
+
+extern HOST_BK4819Stats_t HOST_BK4819Stats;
+
+// Power-on register values, no signals, empty log.
+void HOST_BK4819Reset(void);
+// The model keeps pSignals, not a copy, so a test can move them around.
+void HOST_BK4819SetSignals(const HOST_BK4819Signal_t *pSignals, size_t Count);
+// Raises interrupt flags in 0x02, which shows in bit 0 of 0x0C until the
+// firmware writes 0x02.
+void HOST_BK4819RaiseInterrupt(uint16_t Flags);
+// Register contents as the chip would return them, without a bus access.
+uint16_t HOST_BK4819Peek(uint8_t Reg);
+// The frequency the synthesizer is set to, from 0x38 and 0x39.
+uint32_t HOST_BK4819Frequency(void);
+// Every bus access since the last clear, oldest first.
+const HOST_BK4819Access_t *HOST_BK4819Log(size_t *pCount);
+// Empties the log and zeroes HOST_BK4819Stats.
+void HOST_BK4819ClearLog(void);
+
+#endif
@@ -0,0 +1,52 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef TESTS_HOST_CHECK_H
+#define TESTS_HOST_CHECK_H
+
+#include <stdio.h>
+
+extern unsigned int HOST_Failures;
+
+#define CHECK(Condition)								\
+	do {										\
+		if (!(Condition)) {							\
+			printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #Condition);	\
+			HOST_Failures++;						\
+		}									\
+	} while (0)
+
+#define CHECK_EQUAL(Actual, Expected)							\
+	do {										\
+		const long long ActualValue = (long long)(Actual);			\
+		const long long ExpectedValue = (long long)(Expected);			\
+											\
+		if (ActualValue != ExpectedValue) {					\
+			printf("%s:%d: %s is %lld, expected %lld\n", __FILE__, __LINE__, #Actual, ActualValue, ExpectedValue);	\
+			HOST_Failures++;						\
+		}									\
+	} while (0)
+
+// Runs one test and reports it, returns nothing so a suite is a list of calls.
+#define RUN(Test)									\
+	do {										\
+		const unsigned int Before = HOST_Failures;				\
+											\
+		Test();									\
+		printf("%s %s\n", HOST_Failures == Before ? "PASS" : "FAIL", #Test);	\
+	} while (0)
+
+#endif
@@ -0,0 +1,335 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <stddef.h>
+#include "clock.h"
+
+#define EVENT_COUNT	16
+
+typedef struct {
+	uint64_t Time;
+	void (*pEvent)(void);
+} Event_t;
+
+uint64_t HOST_Time;
+HOST_ClockStats_t HOST_ClockStats;
+
+static void (*pTickHandler)(void);
+static uint64_t LastOverflow;
+static uint64_t NextTick;
+static bool bTickPending;
+static Event_t Events[EVENT_COUNT];
+static uint32_t Primask;
+static uint32_t IrqEnabled;
+// TMR1 as the firmware last left it, to tell its writes apart.
+static uint32_t Tmr1Pr;
+static uint32_t Tmr1Cval;
+static uint32_t Tmr1Ists;
+
+// TMR1 counts at 1 MHz, so one overflow takes PR + 1 us.
+static uint64_t TickPeriod(void)
+{
+	return (HOST_TMR1.pr + 1ULL) * 1000U;
+}
+
+static bool IsTimerCounting(void)
+{
+	return pTickHandler && HOST_TMR1.ctrl1_bit.tmren;
+}
+
+static bool IsTickRunning(void)
+{
+	return IsTimerCounting() && HOST_IsIrqEnabled(TMR1_BRK_OVF_TRG_HALL_IRQn);
+}
+
+static bool bInInterrupt;
+
+static Event_t *NextEvent(void)
+{
+	Event_t *pNext = NULL;
+	uint8_t i;
+
+	for (i = 0; i < EVENT_COUNT; i++) {
+		if (Events[i].pEvent && (!pNext || Events[i].Time < pNext->Time)) {
+			pNext = &Events[i];
+		}
+	}
+
+	return pNext;
+}
+
+// Returns the time of the next tick or event, or UINT64_MAX if neither.
+static uint64_t NextWakeUp(void)
+{
+	const Event_t *pEvent = NextEvent();
+	uint64_t Time = UINT64_MAX;
+
+	if (IsTickRunning()) {
+		Time = bTickPending ? HOST_Time : NextTick;
+	}
+	if (pEvent && pEvent->Time < Time) {
+		Time = pEvent->Time;
+	}
+
+	return Time;
+}
+
+static void SkipOverflows(void)
+{
+	while (NextTick <= HOST_Time) {
+		LastOverflow = NextTick;
+		NextTick += TickPeriod();
+	}
+}
+
+// NVIC_ClearPendingIRQ() drops an overflow that fell due but was not handled
+// yet, the standby code counts it itself.
+static void FollowClearPending(void)
+{
+	volatile uint32_t *pIcpr = &HOST_NVIC.ICPR[TMR1_BRK_OVF_TRG_HALL_IRQn >> 5];
+	const uint32_t Bit = 1U << (TMR1_BRK_OVF_TRG_HALL_IRQn & 31);
+
+	if (*pIcpr & Bit) {
+		*pIcpr &= ~Bit;
+		bTickPending = false;
+		SkipOverflows();
+	}
+}
+
+// A stopped timer loses its overflows. One that runs with its interrupt
+// disabled keeps a single one pending, like the NVIC, and the handler runs
+// once for it when the interrupt is enabled again.
+static void FollowTimer(void)
+{
+	if (NextTick > HOST_Time) {
+		return;
+	}
+	if (!IsTimerCounting()) {
+		LastOverflow = HOST_Time;
+		NextTick = HOST_Time + TickPeriod();
+		return;
+	}
+	if (!HOST_IsIrqEnabled(TMR1_BRK_OVF_TRG_HALL_IRQn)) {
+		bTickPending = true;
+		SkipOverflows();
+	}
+}
+
+// Runs what fell due up to now in time order, as the NVIC would once the
+// interrupts are unmasked. Handlers do not nest.
+static void DeliverPending(void)
+{
+	if (bInInterrupt) {
+		return;
+	}
+	bInInterrupt = true;
+	while (!Primask) {
+		Event_t *pEvent = NextEvent();
+		bool bTickDue;
+
+		FollowClearPending();
+		FollowTimer();
+		bTickDue = IsTickRunning() && (bTickPending || NextTick <= HOST_Time);
+		if (pEvent && pEvent->Time <= HOST_Time && (!bTickDue || bTickPending || pEvent->Time <= NextTick)) {
+			void (*pHandler)(void) = pEvent->pEvent;
+
+			pEvent->pEvent = NULL;
+			pHandler();
+		} else if (bTickDue) {
+			if (bTickPending) {
+				bTickPending = false;
+			} else {
+				LastOverflow = NextTick;
+				NextTick += TickPeriod();
+			}
+			HOST_TMR1.ists |= TMR_OVF_FLAG;
+			Tmr1Ists = HOST_TMR1.ists;
+			HOST_ClockStats.Ticks++;
+			pTickHandler();
+		} else {
+			break;
+		}
+	}
+	bInInterrupt = false;
+}
+
+void __enable_irq(void)
+{
+	Primask = 0;
+	DeliverPending();
+}
+
+void __disable_irq(void)
+{
+	Primask = 1;
+}
+
+uint32_t __get_PRIMASK(void)
+{
+	return Primask;
+}
+
+void __set_PRIMASK(uint32_t Mask)
+{
+	Primask = Mask;
+	if (!Mask) {
+		DeliverPending();
+	}
+}
+
+// Sleeps until the next tick or event; a masked one still ends the sleep
+// but only runs once the interrupts are unmasked again.
+void __WFI(void)
+{
+	const uint64_t Time = NextWakeUp();
+
+	if (Time != UINT64_MAX && HOST_Time < Time) {
+		HOST_ClockStats.Idle += Time - HOST_Time;
+	}
+	HOST_ClockStats.Wakeups++;
+	HOST_Idle();
+}
+
+bool HOST_IsMasked(void)
+{
+	return Primask != 0;
+}
+
+void HOST_EnableIrq(IRQn_Type Irq, bool bEnable)
+{
+	if (bEnable) {
+		IrqEnabled |= 1U << Irq;
+		DeliverPending();
+	} else {
+		IrqEnabled &= ~(1U << Irq);
+	}
+}
+
+bool HOST_IsIrqEnabled(IRQn_Type Irq)
+{
+	return IrqEnabled & (1U << Irq);
+}
+
+void HOST_Spend(uint64_t Nanoseconds)
+{
+	HOST_Time += Nanoseconds;
+}
+
+void HOST_SetTickHandler(void (*pHandler)(void))
+{
+	pTickHandler = pHandler;
+	LastOverflow = HOST_Time;
+	NextTick = HOST_Time + TickPeriod();
+}
+
+// Firmware writes since the last access come first: a new period without
+// buffering or a new count moves the next overflow, and ists clears the bits
+// written as 0. Then the counter and the overflow flag are brought up to the
+// virtual time.
+tmr_type *HOST_ReadTmr1(void)
+{
+	FollowClearPending();
+	if (HOST_TMR1.cval != Tmr1Cval) {
+		LastOverflow = HOST_Time - (HOST_TMR1.cval * 1000ULL);
+		NextTick = LastOverflow + TickPeriod();
+	} else if (HOST_TMR1.pr != Tmr1Pr && !HOST_TMR1.ctrl1_bit.prben) {
+		NextTick = LastOverflow + TickPeriod();
+		// Already past the new period, the counter runs on to 0xFFFF.
+		if (NextTick <= HOST_Time) {
+			NextTick = LastOverflow + 65536000ULL;
+		}
+	}
+	HOST_TMR1.ists &= Tmr1Ists;
+	if (IsTimerCounting()) {
+		if (bTickPending || NextTick <= HOST_Time) {
+			HOST_TMR1.ists |= TMR_OVF_FLAG;
+		}
+		if (NextTick <= HOST_Time) {
+			HOST_TMR1.cval = (uint32_t)(((HOST_Time - NextTick) % TickPeriod()) / 1000U);
+		} else {
+			HOST_TMR1.cval = (uint32_t)((HOST_Time - LastOverflow) / 1000U);
+		}
+	}
+	Tmr1Pr = HOST_TMR1.pr;
+	Tmr1Cval = HOST_TMR1.cval;
+	Tmr1Ists = HOST_TMR1.ists;
+
+	return &HOST_TMR1;
+}
+
+void HOST_DeliverPending(void)
+{
+	DeliverPending();
+}
+
+void HOST_At(uint64_t Time, void (*pEvent)(void))
+{
+	uint8_t i;
+
+	for (i = 0; i < EVENT_COUNT; i++) {
+		if (!Events[i].pEvent) {
+			Events[i].Time = Time;
+			Events[i].pEvent = pEvent;
+			return;
+		}
+	}
+}
+
+void HOST_Idle(void)
+{
+	const uint64_t Time = NextWakeUp();
+
+	if (Time == UINT64_MAX) {
+		return;
+	}
+	if (HOST_Time < Time) {
+		HOST_Time = Time;
+	}
+	DeliverPending();
+}
+
+void HOST_RunUntil(uint64_t Time)
+{
+	DeliverPending();
+	while (!Primask && NextWakeUp() <= Time) {
+		HOST_Idle();
+	}
+	if (HOST_Time < Time) {
+		HOST_Time = Time;
+	}
+}
+
+void HOST_ResetClock(void)
+{
+	uint8_t i;
+
+	HOST_Time = 0;
+	Primask = 0;
+	IrqEnabled = 0xFFFFFFFFU;
+	bTickPending = false;
+	bInInterrupt = false;
+	for (i = 0; i < EVENT_COUNT; i++) {
+		Events[i].pEvent = NULL;
+	}
+	LastOverflow = 0;
+	NextTick = TickPeriod();
+	Tmr1Pr = HOST_TMR1.pr;
+	Tmr1Cval = HOST_TMR1.cval;
+	Tmr1Ists = HOST_TMR1.ists;
+	HOST_ClockStats.Idle = 0;
+	HOST_ClockStats.Wakeups = 0;
+	HOST_ClockStats.Ticks = 0;
+}
@@ -0,0 +1,63 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef TESTS_HOST_CLOCK_H
+#define TESTS_HOST_CLOCK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+	// Time the core slept in __WFI(), in ns. The delays of driver/delay.h
+	// spin on the radio and do not count.
+	uint64_t Idle;
+	// __WFI() calls.
+	uint32_t Wakeups;
+	// TMR1 handler runs.
+	uint32_t Ticks;
+} HOST_ClockStats_t;
+
+extern HOST_ClockStats_t HOST_ClockStats;
+
+// Virtual time in ns since the start of the run. Only the models and the
+// idle loop move it, so every run of the same input gives the same timings.
+extern uint64_t HOST_Time;
+
+// Charges time spent by the firmware. Interrupts that fall due meanwhile stay
+// pending until the next interrupt boundary, HOST_DeliverPending(), which
+// the models also call at the end of every pin read and write and every
+// BK4819 access.
+void HOST_Spend(uint64_t Nanoseconds);
+// Called once per TMR1 overflow while TMR1 runs, its interrupt is enabled and
+// interrupts are unmasked.
+// The overflow flag in ists is set before each call.
+void HOST_SetTickHandler(void (*pHandler)(void));
+void HOST_DeliverPending(void);
+// Idles until Time, running the ticks that fall due on the way.
+void HOST_RunUntil(uint64_t Time);
+// Schedules pEvent at Time, the idle loop wakes for it like for an interrupt.
+void HOST_At(uint64_t Time, void (*pEvent)(void));
+// Moves to the next tick or event, whichever is first, and runs it.
+void HOST_Idle(void);
+// Back to time zero with every interrupt enabled and unmasked, and the
+// statistics cleared.
+void HOST_ResetClock(void);
+bool HOST_IsMasked(void);
+// The NVIC enable bits, set and cleared by the host bsp/misc.c.
+void HOST_EnableIrq(IRQn_Type Irq, bool bEnable);
+bool HOST_IsIrqEnabled(IRQn_Type Irq);
+
+#endif
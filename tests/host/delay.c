@@ -0,0 +1,45 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+// Replaces driver/delay.c. The waits idle the virtual clock, so the ticks and
+// events that fall due meanwhile run as they would beside the SysTick loop.
+
+#include "clock.h"
+#include "driver/delay.h"
+
+// The core clock the firmware runs at once CRM_InitPeripherals() is done.
+#define CORE_CLOCK	72000000U
+
+void DELAY_Init(void)
+{
+	DWT->CYCCNT = 0;
+}
+
+uint32_t DELAY_GetHalfPeriod(uint32_t Frequency)
+{
+	return (CORE_CLOCK + (2 * Frequency) - 1) / (2 * Frequency);
+}
+
+void DELAY_WaitUS(uint32_t Delay)
+{
+	HOST_RunUntil(HOST_Time + (Delay * 1000ULL));
+}
+
+void DELAY_WaitMS(uint16_t Delay)
+{
+	// The driver adds 13 ms to every 500 ms it waits.
+	HOST_RunUntil(HOST_Time + (Delay * 1000000ULL) + ((Delay / 500) * 13000000ULL));
+}
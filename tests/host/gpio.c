@@ -0,0 +1,194 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+// Replaces bsp/gpio.c. The latches live in the HOST_GPIOx blocks, reads of an
+// input come from what HOST_GpioDrive() put on the pin.
+
+#include <string.h>
+#include "clock.h"
+#include "gpio.h"
+
+#define LISTENER_COUNT	8
+
+static void (*Listeners[LISTENER_COUNT])(void);
+
+static gpio_type *const Ports[] = {
+	&HOST_GPIOA,
+	&HOST_GPIOB,
+	&HOST_GPIOC,
+	&HOST_GPIOF,
+};
+
+static uint16_t Driven[sizeof(Ports) / sizeof(Ports[0])];
+
+static uint8_t PortIndex(const gpio_type *pGpio)
+{
+	uint8_t i;
+
+	for (i = 0; i < sizeof(Ports) / sizeof(Ports[0]); i++) {
+		if (Ports[i] == pGpio) {
+			break;
+		}
+	}
+
+	return i;
+}
+
+// Output pins read back their own latch, like on the chip.
+static void UpdateInput(gpio_type *pGpio)
+{
+	uint16_t Outputs = 0;
+	uint8_t i;
+
+	for (i = 0; i < 16; i++) {
+		if (((pGpio->cfgr >> (i * 2)) & 3U) == GPIO_MODE_OUTPUT) {
+			Outputs |= 1U << i;
+		}
+	}
+	pGpio->idt = (pGpio->odt & Outputs) | (Driven[PortIndex(pGpio)] & ~Outputs);
+}
+
+// Like a read, a write ends on an interrupt boundary, after the listeners saw
+// it. The ticks then land in the middle of long bit-banged transfers as they
+// do on the radio.
+static void SetLatch(gpio_type *pGpio, uint16_t Odt)
+{
+	uint8_t i;
+
+	HOST_Spend(HOST_GPIO_NS);
+	if (pGpio->odt != Odt) {
+		pGpio->odt = Odt;
+		UpdateInput(pGpio);
+		for (i = 0; i < LISTENER_COUNT && Listeners[i]; i++) {
+			Listeners[i]();
+		}
+	}
+	HOST_DeliverPending();
+}
+
+void HOST_GpioListen(void (*pListener)(void))
+{
+	uint8_t i;
+
+	for (i = 0; i < LISTENER_COUNT; i++) {
+		if (!Listeners[i]) {
+			Listeners[i] = pListener;
+			return;
+		}
+	}
+}
+
+void HOST_GpioDrive(gpio_type *pGpio, uint16_t Pins, bool bHigh)
+{
+	const uint8_t Index = PortIndex(pGpio);
+
+	if (bHigh) {
+		Driven[Index] |= Pins;
+	} else {
+		Driven[Index] &= ~Pins;
+	}
+	UpdateInput(pGpio);
+}
+
+bool HOST_GpioOutput(const gpio_type *pGpio, uint16_t Pin)
+{
+	return pGpio->odt & Pin;
+}
+
+void HOST_GpioReset(void)
+{
+	uint8_t i;
+
+	memset(Listeners, 0, sizeof(Listeners));
+	for (i = 0; i < sizeof(Ports) / sizeof(Ports[0]); i++) {
+		memset(Ports[i], 0, sizeof(*Ports[i]));
+		Driven[i] = 0xFFFF;
+		UpdateInput(Ports[i]);
+	}
+}
+
+void gpio_bits_flip(gpio_type *gpio, uint16_t pins)
+{
+	SetLatch(gpio, gpio->odt ^ pins);
+}
+
+void gpio_default_para_init_ex(gpio_init_type *init)
+{
+	init->gpio_pins  = GPIO_PINS_ALL;
+	init->gpio_mode = GPIO_MODE_INPUT;
+	init->gpio_out_type = GPIO_OUTPUT_PUSH_PULL;
+	init->gpio_pull = GPIO_PULL_NONE;
+	init->gpio_drive_strength = GPIO_DRIVE_STRENGTH_MODERATE;
+}
+
+void gpio_bits_set(gpio_type *gpio_x, uint16_t pins)
+{
+	SetLatch(gpio_x, gpio_x->odt | pins);
+}
+
+void gpio_bits_reset(gpio_type *gpio_x, uint16_t pins)
+{
+	SetLatch(gpio_x, gpio_x->odt & ~pins);
+}
+
+// A read ends on an interrupt boundary, so loops that poll a pin still see
+// the ticks fall due.
+flag_status gpio_input_data_bit_read(gpio_type *gpio_x, uint16_t pins)
+{
+	HOST_Spend(HOST_GPIO_NS);
+	HOST_DeliverPending();
+
+	return (gpio_x->idt & pins) == pins ? SET : RESET;
+}
+
+flag_status gpio_output_data_bit_read(gpio_type *gpio_x, uint16_t pins)
+{
+	return (gpio_x->odt & pins) ? SET : RESET;
+}
+
+void gpio_init(gpio_type *gpio_x, gpio_init_type *gpio_init_struct)
+{
+	uint16_t pinx_value, pin_index = 0;
+
+	pinx_value = (uint16_t)gpio_init_struct->gpio_pins;
+
+	while (pinx_value > 0) {
+		if (pinx_value & 0x01) {
+			gpio_x->cfgr  &= (uint32_t)~(0x03 << (pin_index * 2));
+			gpio_x->cfgr  |= (uint32_t)(gpio_init_struct->gpio_mode << (pin_index * 2));
+
+			gpio_x->omode &= (uint32_t)~(0x01 << (pin_index));
+			gpio_x->omode |= (uint32_t)(gpio_init_struct->gpio_out_type << (pin_index));
+
+			gpio_x->odrvr &= (uint32_t)~(0x03 << (pin_index * 2));
+			gpio_x->odrvr |= (uint32_t)(gpio_init_struct->gpio_drive_strength << (pin_index * 2));
+
+			gpio_x->pull  &= (uint32_t)~(0x03 << (pin_index * 2));
+			gpio_x->pull  |= (uint32_t)(gpio_init_struct->gpio_pull << (pin_index * 2));
+		}
+		pinx_value >>= 1;
+		pin_index++;
+	}
+	UpdateInput(gpio_x);
+}
+
+void gpio_pin_mux_config(gpio_type *gpio_x, gpio_pins_source_type gpio_pin_source, gpio_mux_sel_type gpio_mux)
+{
+	volatile uint32_t *pMux = (gpio_pin_source >> 3) ? &gpio_x->muxh : &gpio_x->muxl;
+	const uint32_t Shift = (gpio_pin_source & 7U) * 4;
+
+	*pMux = (*pMux & ~(0xFU << Shift)) | ((uint32_t)gpio_mux << Shift);
+}
@@ -0,0 +1,35 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef TESTS_HOST_GPIO_H
+#define TESTS_HOST_GPIO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Rough cost of one call into the GPIO driver, call overhead included.
+#define HOST_GPIO_NS	(7U * HOST_CYCLE_NS)
+
+// pListener runs after every change of an output latch, so a model can
+// follow the bit-banged buses. Up to eight listeners.
+void HOST_GpioListen(void (*pListener)(void));
+// Sets the level a model or the outside world puts on input pins.
+void HOST_GpioDrive(gpio_type *pGpio, uint16_t Pins, bool bHigh);
+bool HOST_GpioOutput(const gpio_type *pGpio, uint16_t Pin);
+// Drops the listeners, clears the latches and pulls every input high.
+void HOST_GpioReset(void);
+
+#endif
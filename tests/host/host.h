@@ -0,0 +1,152 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+// Forced ahead of every source of the host build with -include. It stands in
+// for the Cortex-M intrinsics of cmsis_gcc.h and points the peripheral macros
+// at plain structs, so the firmware sources build unchanged for the PC.
+
+#ifndef TESTS_HOST_HOST_H
+#define TESTS_HOST_HOST_H
+
+#include <stdint.h>
+
+#define __CMSIS_GCC_H
+
+#define __ASM			__asm
+#define __INLINE		inline
+#define __STATIC_INLINE		static inline
+#define __STATIC_FORCEINLINE	__attribute__((always_inline)) static inline
+#define __NO_RETURN		__attribute__((__noreturn__))
+#define __USED			__attribute__((used))
+#define __WEAK			__attribute__((weak))
+#define __PACKED		__attribute__((packed, aligned(1)))
+#define __PACKED_STRUCT		struct __attribute__((packed, aligned(1)))
+#define __PACKED_UNION		union __attribute__((packed, aligned(1)))
+#define __ALIGNED(x)		__attribute__((aligned(x)))
+#define __RESTRICT		__restrict
+#define __COMPILER_BARRIER()	__asm volatile("" ::: "memory")
+
+#define __NOP()			((void)0)
+#define __DSB()			__COMPILER_BARRIER()
+#define __DMB()			__COMPILER_BARRIER()
+#define __ISB()			__COMPILER_BARRIER()
+
+void __enable_irq(void);
+void __disable_irq(void);
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t Mask);
+void __WFI(void);
+
+#include <at32f421.h>
+
+extern adc_type HOST_ADC1;
+extern crm_type HOST_CRM;
+extern dma_type HOST_DMA1;
+extern dma_channel_type HOST_DMA1_CHANNEL1;
+extern flash_type HOST_FLASH;
+extern gpio_type HOST_GPIOA;
+extern gpio_type HOST_GPIOB;
+extern gpio_type HOST_GPIOC;
+extern gpio_type HOST_GPIOF;
+extern tmr_type HOST_TMR1;
+extern tmr_type HOST_TMR3;
+extern tmr_type HOST_TMR6;
+extern tmr_type HOST_TMR14;
+extern tmr_type HOST_TMR15;
+extern tmr_type HOST_TMR16;
+extern tmr_type HOST_TMR17;
+extern usart_type HOST_USART1;
+extern usart_type HOST_USART2;
+extern SCB_Type HOST_SCB;
+extern NVIC_Type HOST_NVIC;
+extern DWT_Type HOST_DWT;
+extern SysTick_Type HOST_SysTick;
+extern CoreDebug_Type HOST_CoreDebug;
+
+#undef ADC1
+#undef CRM
+#undef DMA1
+#undef DMA1_CHANNEL1
+#undef FLASH
+#undef GPIOA
+#undef GPIOB
+#undef GPIOC
+#undef GPIOF
+#undef TMR1
+#undef TMR3
+#undef TMR6
+#undef TMR14
+#undef TMR15
+#undef TMR16
+#undef TMR17
+#undef USART1
+#undef USART2
+#undef SCB
+#undef NVIC
+#undef DWT
+#undef SysTick
+#undef CoreDebug
+
+#define ADC1		(HOST_ReadAdc())
+#define CRM		(&HOST_CRM)
+#define DMA1		(&HOST_DMA1)
+#define DMA1_CHANNEL1	(&HOST_DMA1_CHANNEL1)
+#define FLASH		(&HOST_FLASH)
+#define GPIOA		(&HOST_GPIOA)
+#define GPIOB		(&HOST_GPIOB)
+#define GPIOC		(&HOST_GPIOC)
+#define GPIOF		(&HOST_GPIOF)
+#define TMR1		(HOST_ReadTmr1())
+#define TMR3		(&HOST_TMR3)
+#define TMR6		(&HOST_TMR6)
+#define TMR14		(&HOST_TMR14)
+#define TMR15		(&HOST_TMR15)
+#define TMR16		(&HOST_TMR16)
+#define TMR17		(&HOST_TMR17)
+#define USART1		(&HOST_USART1)
+#define USART2		(&HOST_USART2)
+#define SCB		(&HOST_SCB)
+#define NVIC		(&HOST_NVIC)
+#define DWT		(HOST_ReadDwt())
+#define SysTick		(&HOST_SysTick)
+#define CoreDebug	(&HOST_CoreDebug)
+
+// The clock enable and reset bits are found from CRM_BASE otherwise.
+#undef CRM_REG
+#define CRM_REG(value)	(*(volatile uint32_t *)((uint8_t *)&HOST_CRM + ((value) >> 16)))
+
+// The ADC converts and calibrates in no time, host/adc.c. The TMR1 counter
+// and overflow flag follow the virtual clock, host/clock.c.
+adc_type *HOST_ReadAdc(void);
+tmr_type *HOST_ReadTmr1(void);
+
+// One CPU cycle at 72 MHz, rounded, for the costs charged by the models.
+#define HOST_CYCLE_NS	14U
+
+extern uint64_t HOST_Time;
+
+// Each look at the cycle counter costs a cycle and returns the virtual time,
+// so the edge waits of driver/delay.h and the cycle counts of the profiler
+// and the BK4819 trace run on the same clock as everything else.
+static inline DWT_Type *HOST_ReadDwt(void)
+{
+	HOST_Time += HOST_CYCLE_NS;
+	HOST_DWT.CYCCNT = (uint32_t)(HOST_Time / HOST_CYCLE_NS);
+
+	return &HOST_DWT;
+}
+
+#endif
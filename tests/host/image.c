@@ -0,0 +1,99 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <string.h>
+#include "image.h"
+#include "radio/frequencies.h"
+#include "radio/settings.h"
+
+#define CALIBRATION_ADDRESS	0x3BF000U
+#define BAND_TABLE_ADDRESS	0x3BF020U
+#define BAND_COUNT		8U
+
+static void FormatCalibration(uint8_t *pImage)
+{
+	Calibration_t Calibration;
+	uint8_t i;
+
+	memset(&Calibration, 0, sizeof(Calibration));
+	Calibration._0x00 = 0x9A;
+	Calibration.BandSelectionThreshold = 0x0F30;
+	Calibration.AF_RX_Expander = 0x0000;
+	Calibration.AF_TX_Compress = 0x0000;
+	// Battery levels in 0.1 V from empty up.
+	for (i = 0; i < sizeof(Calibration.BatteryCalibration); i++) {
+		Calibration.BatteryCalibration[i] = 64 + (i * 2);
+	}
+	memcpy(pImage + CALIBRATION_ADDRESS, &Calibration, sizeof(Calibration));
+}
+
+static void FormatBands(uint8_t *pImage)
+{
+	FrequencyBandInfo_t Band;
+	uint8_t i;
+
+	memset(&Band, 0, sizeof(Band));
+	// 32768 is a perfect crystal, 0x38 and 0x39 then carry the frequency.
+	Band.FrequencyOffset = 32768;
+	Band.MicSensitivityTuningWide = 0x10;
+	Band.TxDeviationWide = 0x04D0;
+	Band.CtcssTxGainWide = 0x40;
+	Band.DcsTxGainWide = 0x20;
+	Band.RX_DAC_GainWide = 0xE0;
+	Band.MicSensitivityTuningNarrow = 0x10;
+	Band.TxDeviationNarrow = 0x0270;
+	Band.CtcssTxGainNarrow = 0x40;
+	Band.DcsTxGainNarrow = 0x20;
+	Band.RX_DAC_GainNarrow = 0xE0;
+	memset(Band.TxPowerLevelHigh, 0x80, sizeof(Band.TxPowerLevelHigh));
+	memset(Band.TxPowerLevelLow, 0x30, sizeof(Band.TxPowerLevelLow));
+	memset(Band.SquelchNoiseWide, HOST_IMAGE_SQUELCH_NOISE, sizeof(Band.SquelchNoiseWide));
+	memset(Band.SquelchRSSIWide, HOST_IMAGE_SQUELCH_RSSI, sizeof(Band.SquelchRSSIWide));
+	memset(Band.SquelchNoiseNarrow, HOST_IMAGE_SQUELCH_NOISE, sizeof(Band.SquelchNoiseNarrow));
+	memset(Band.SquelchRSSINarrow, HOST_IMAGE_SQUELCH_RSSI, sizeof(Band.SquelchRSSINarrow));
+
+	for (i = 0; i < BAND_COUNT; i++) {
+		memcpy(pImage + BAND_TABLE_ADDRESS + (i * sizeof(Band)), &Band, sizeof(Band));
+	}
+}
+
+static void FormatSettings(uint8_t *pImage)
+{
+	gSettings_t Settings;
+
+	memset(&Settings, 0, sizeof(Settings));
+	Settings.KeyBeep = 1;
+	Settings.DisplayLabel = 1;
+	Settings.FrequencyStep = 8;
+	Settings.Squelch = 1;
+	Settings.DisplayTimer = 30;
+	Settings.TimeoutTimer = 12;
+	Settings.FmFrequency = 9650;
+	Settings.VfoChNo[0] = 999;
+	Settings.VfoChNo[1] = 1000;
+	Settings.bEnableDisplay = 1;
+	Settings.WelcomeX = 0xFF;
+	Settings.WelcomeY = 0xFF;
+	Settings.DtmfState = DTMF_STATE_NORMAL;
+	memcpy(pImage + HOST_IMAGE_SETTINGS, &Settings, sizeof(Settings));
+}
+
+void HOST_ImageFormat(uint8_t *pImage)
+{
+	FormatCalibration(pImage);
+	FormatBands(pImage);
+	FormatSettings(pImage);
+}
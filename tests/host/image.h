@@ -0,0 +1,35 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef TESTS_HOST_IMAGE_H
+#define TESTS_HOST_IMAGE_H
+
+#include <stdint.h>
+
+// Squelch thresholds of every band and level in the image, in the units of
+// the RSSI in 0x67 and the noise in 0x65.
+#define HOST_IMAGE_SQUELCH_RSSI	80U
+#define HOST_IMAGE_SQUELCH_NOISE	40U
+
+// Where gSettings_t sits in the image.
+#define HOST_IMAGE_SETTINGS	0x3C1030U
+
+// Writes a made-up but consistent calibration, band table and settings into
+// the flash image, as the PC tools would on a radio. The channels stay
+// erased, the firmware puts its VFO defaults there on boot.
+void HOST_ImageFormat(uint8_t *pImage);
+
+#endif
@@ -0,0 +1,120 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+// The 4 x 4 key matrix. A held key connects its column output to its row
+// input, so the row reads low while the firmware drives that column low.
+// PTT and the side keys pull their pins straight to ground.
+
+#include "driver/pins.h"
+#include "gpio.h"
+#include "keypad.h"
+
+typedef struct {
+	gpio_type *pGpio;
+	uint16_t Pin;
+} Pin_t;
+
+// Column Base is the one driven low while driver/key.c reads bits Base * 4
+// to Base * 4 + 3 of KeyPressed, one per row.
+static const Pin_t Rows[4] = {
+	{ &HOST_GPIOA, BOARD_GPIOA_KEY_ROW0 },
+	{ &HOST_GPIOB, BOARD_GPIOB_KEY_ROW1 },
+	{ &HOST_GPIOB, BOARD_GPIOB_KEY_ROW2 },
+	{ &HOST_GPIOA, BOARD_GPIOA_KEY_ROW3 },
+};
+
+static const Pin_t Columns[4] = {
+	{ &HOST_GPIOA, BOARD_GPIOA_KEY_COL3 },
+	{ &HOST_GPIOB, BOARD_GPIOB_KEY_COL0 },
+	{ &HOST_GPIOB, BOARD_GPIOB_KEY_COL1 },
+	{ &HOST_GPIOB, BOARD_GPIOB_KEY_COL2 },
+};
+
+// Bit of each key in KeyPressed, the inverse of KEY_GetButton().
+static const uint8_t Bits[KEY_NONE] = {
+	[KEY_MENU] = 0,  [KEY_1] = 1,  [KEY_4] = 2,   [KEY_7] = 3,
+	[KEY_UP] = 4,    [KEY_2] = 5,  [KEY_5] = 6,   [KEY_8] = 7,
+	[KEY_DOWN] = 8,  [KEY_3] = 9,  [KEY_6] = 10,  [KEY_9] = 11,
+	[KEY_EXIT] = 12, [KEY_STAR] = 13, [KEY_0] = 14, [KEY_HASH] = 15,
+};
+
+static KEY_t Held = KEY_NONE;
+static uint8_t Driven;
+
+static uint8_t ReadColumns(void)
+{
+	uint8_t Levels = 0;
+	uint8_t i;
+
+	for (i = 0; i < 4; i++) {
+		if (HOST_GpioOutput(Columns[i].pGpio, Columns[i].Pin)) {
+			Levels |= 1U << i;
+		}
+	}
+
+	return Levels;
+}
+
+static void UpdateRows(void)
+{
+	uint8_t i;
+
+	Driven = ReadColumns();
+	for (i = 0; i < 4; i++) {
+		HOST_GpioDrive(Rows[i].pGpio, Rows[i].Pin, true);
+	}
+	if (Held != KEY_NONE) {
+		const Pin_t *pColumn = &Columns[Bits[Held] / 4];
+		const Pin_t *pRow = &Rows[Bits[Held] % 4];
+
+		HOST_GpioDrive(pRow->pGpio, pRow->Pin, HOST_GpioOutput(pColumn->pGpio, pColumn->Pin));
+	}
+}
+
+// Runs on every latch change, most of them on the LCD bus.
+static void FollowColumns(void)
+{
+	if (ReadColumns() != Driven) {
+		UpdateRows();
+	}
+}
+
+void HOST_KeypadReset(void)
+{
+	Held = KEY_NONE;
+	HOST_GpioListen(FollowColumns);
+	UpdateRows();
+}
+
+void HOST_KeypadSet(KEY_t Key)
+{
+	Held = Key;
+	UpdateRows();
+}
+
+void HOST_KeypadPtt(bool bPressed)
+{
+	HOST_GpioDrive(&HOST_GPIOB, BOARD_GPIOB_KEY_PTT, !bPressed);
+}
+
+void HOST_KeypadSide(uint8_t Side, bool bPressed)
+{
+	if (Side == 1) {
+		HOST_GpioDrive(&HOST_GPIOF, BOARD_GPIOF_KEY_SIDE1, !bPressed);
+	} else {
+		HOST_GpioDrive(&HOST_GPIOA, BOARD_GPIOA_KEY_SIDE2, !bPressed);
+	}
+}
@@ -0,0 +1,32 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef TESTS_HOST_KEYPAD_H
+#define TESTS_HOST_KEYPAD_H
+
+#include <stdbool.h>
+#include "driver/key.h"
+
+// Starts following the keypad columns, every key up.
+void HOST_KeypadReset(void);
+// Holds Key down, KEY_NONE releases it. One key at a time, as the firmware
+// reads them.
+void HOST_KeypadSet(KEY_t Key);
+void HOST_KeypadPtt(bool bPressed);
+// Side key 1 or 2.
+void HOST_KeypadSide(uint8_t Side, bool bPressed);
+
+#endif
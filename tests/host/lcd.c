@@ -0,0 +1,181 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+// The ST7735S of driver/st7735s.c, decoded from its pins: a byte is shifted
+// in MSB first on the rising edges of SCL while CS is low, DCX low makes it
+// a command. Only the address window and the pixel writes are modelled.
+
+#include <stdio.h>
+#include <string.h>
+#include "driver/pins.h"
+#include "driver/st7735s.h"
+#include "gpio.h"
+#include "lcd.h"
+
+HOST_LcdStats_t HOST_LcdStats;
+
+static uint16_t Frame[HOST_LCD_WIDTH][HOST_LCD_HEIGHT];
+static bool bClock;
+static uint8_t Shift;
+static uint8_t Bits;
+static uint8_t Command;
+static uint8_t Parameter;
+// The window in panel columns (Y) and rows (X), and where RAMWR is at.
+static uint16_t Window[4];
+static uint16_t Column;
+static uint16_t Row;
+static uint8_t PixelHigh;
+
+static void SetWindowByte(uint8_t Index, uint8_t Data)
+{
+	const uint8_t Word = Index / 2;
+
+	if (Index & 1U) {
+		Window[Word] = (Window[Word] & 0xFF00U) | Data;
+	} else {
+		Window[Word] = (Window[Word] & 0x00FFU) | (Data << 8);
+	}
+}
+
+static void WritePixel(uint16_t Color)
+{
+	if (Row < HOST_LCD_WIDTH && Column < HOST_LCD_HEIGHT) {
+		Frame[Row][Column] = Color;
+	}
+	HOST_LcdStats.Pixels++;
+	if (Column++ >= Window[1]) {
+		Column = Window[0];
+		if (Row++ >= Window[3]) {
+			Row = Window[2];
+		}
+	}
+}
+
+static void ReceiveByte(uint8_t Byte, bool bCommand)
+{
+	if (bCommand) {
+		HOST_LcdStats.Commands++;
+		Command = Byte;
+		Parameter = 0;
+		if (Command == ST7735S_CMD_RAMWR) {
+			Column = Window[0];
+			Row = Window[2];
+		}
+		return;
+	}
+
+	HOST_LcdStats.Data++;
+	switch (Command) {
+	case ST7735S_CMD_CASET:
+		if (Parameter < 4) {
+			SetWindowByte(Parameter, Byte);
+		}
+		break;
+
+	case ST7735S_CMD_RASET:
+		if (Parameter < 4) {
+			SetWindowByte(Parameter + 4, Byte);
+		}
+		break;
+
+	case ST7735S_CMD_RAMWR:
+		if (Parameter & 1U) {
+			WritePixel((PixelHigh << 8) | Byte);
+		} else {
+			PixelHigh = Byte;
+		}
+		break;
+
+	default:
+		break;
+	}
+	Parameter++;
+}
+
+static void FollowBus(void)
+{
+	const bool bLastClock = bClock;
+
+	bClock = HOST_GpioOutput(&HOST_GPIOA, BOARD_GPIOA_LCD_SCL);
+	if (HOST_GpioOutput(&HOST_GPIOC, BOARD_GPIOC_LCD_CS)) {
+		Bits = 0;
+		return;
+	}
+	if (bLastClock || !bClock) {
+		return;
+	}
+	Shift = (Shift << 1) | HOST_GpioOutput(&HOST_GPIOA, BOARD_GPIOA_LCD_SDA);
+	if (++Bits == 8) {
+		Bits = 0;
+		ReceiveByte(Shift, !HOST_GpioOutput(&HOST_GPIOF, BOARD_GPIOF_LCD_DCX));
+	}
+}
+
+void HOST_LcdReset(void)
+{
+	memset(Frame, 0, sizeof(Frame));
+	memset(&HOST_LcdStats, 0, sizeof(HOST_LcdStats));
+	bClock = false;
+	Bits = 0;
+	Command = 0;
+	Parameter = 0;
+	Window[0] = 0;
+	Window[1] = HOST_LCD_HEIGHT - 1;
+	Window[2] = 0;
+	Window[3] = HOST_LCD_WIDTH - 1;
+	HOST_GpioListen(FollowBus);
+}
+
+uint16_t HOST_LcdPixel(uint8_t X, uint8_t Y)
+{
+	return Frame[X][Y];
+}
+
+uint32_t HOST_LcdHash(void)
+{
+	const uint8_t *pBytes = (const uint8_t *)Frame;
+	uint32_t Hash = 2166136261U;
+	size_t i;
+
+	for (i = 0; i < sizeof(Frame); i++) {
+		Hash = (Hash ^ pBytes[i]) * 16777619U;
+	}
+
+	return Hash;
+}
+
+bool HOST_LcdDump(const char *pPath)
+{
+	FILE *pFile = fopen(pPath, "wb");
+	int X, Y;
+
+	if (!pFile) {
+		return false;
+	}
+	fprintf(pFile, "P6\n%u %u\n255\n", HOST_LCD_WIDTH, HOST_LCD_HEIGHT);
+	for (Y = HOST_LCD_HEIGHT - 1; Y >= 0; Y--) {
+		for (X = 0; X < (int)HOST_LCD_WIDTH; X++) {
+			// COLOR_RGB() of ui/gfx.h keeps red in the low bits.
+			const uint16_t Color = Frame[X][Y];
+
+			fputc(((Color >> 0) & 0x1FU) * 255 / 31, pFile);
+			fputc(((Color >> 5) & 0x3FU) * 255 / 63, pFile);
+			fputc(((Color >> 11) & 0x1FU) * 255 / 31, pFile);
+		}
+	}
+
+	return fclose(pFile) == 0;
+}
@@ -0,0 +1,45 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef TESTS_HOST_LCD_H
+#define TESTS_HOST_LCD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// The frame in the coordinates of ui/: X runs along the panel memory rows,
+// Y along its columns.
+#define HOST_LCD_WIDTH	160U
+#define HOST_LCD_HEIGHT	128U
+
+typedef struct {
+	uint32_t Commands;
+	uint32_t Data;
+	uint32_t Pixels;
+} HOST_LcdStats_t;
+
+extern HOST_LcdStats_t HOST_LcdStats;
+
+// Starts following the bit-banged ST7735S bus with a black frame and the
+// power-on address window.
+void HOST_LcdReset(void);
+uint16_t HOST_LcdPixel(uint8_t X, uint8_t Y);
+// FNV-1a of the frame, to compare screens without keeping them.
+uint32_t HOST_LcdHash(void);
+// Writes the frame as a binary PPM with Y up, as ui/ draws it.
+bool HOST_LcdDump(const char *pPath);
+
+#endif
@@ -0,0 +1,39 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+// Replaces bsp/misc.c. The NVIC enable bits go to the virtual clock, which
+// holds back the handlers of disabled interrupts.
+
+#include "clock.h"
+
+void systick_clock_source_config(systick_clock_source_type source)
+{
+	if (source == SYSTICK_CLOCK_SOURCE_AHBCLK_NODIV) {
+		SysTick->CTRL |= SYSTICK_CLOCK_SOURCE_AHBCLK_NODIV;
+	} else {
+		SysTick->CTRL &= ~(uint32_t)SYSTICK_CLOCK_SOURCE_AHBCLK_NODIV;
+	}
+}
+
+void nvic_irq_enable(IRQn_Type irqn, uint32_t preempt_priority, uint32_t sub_priority)
+{
+	HOST_EnableIrq(irqn, true);
+}
+
+void nvic_irq_disable(IRQn_Type irqn)
+{
+	HOST_EnableIrq(irqn, false);
+}
@@ -0,0 +1,45 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+// Register blocks the firmware reads and writes in place of the peripherals.
+// Anything that must react to a write goes through a host driver instead.
+
+adc_type HOST_ADC1;
+crm_type HOST_CRM;
+dma_type HOST_DMA1;
+dma_channel_type HOST_DMA1_CHANNEL1;
+flash_type HOST_FLASH;
+gpio_type HOST_GPIOA;
+gpio_type HOST_GPIOB;
+gpio_type HOST_GPIOC;
+gpio_type HOST_GPIOF;
+tmr_type HOST_TMR1;
+tmr_type HOST_TMR3;
+tmr_type HOST_TMR6;
+tmr_type HOST_TMR14;
+tmr_type HOST_TMR15;
+tmr_type HOST_TMR16;
+tmr_type HOST_TMR17;
+usart_type HOST_USART1;
+usart_type HOST_USART2;
+SCB_Type HOST_SCB;
+NVIC_Type HOST_NVIC;
+DWT_Type HOST_DWT;
+SysTick_Type HOST_SysTick;
+CoreDebug_Type HOST_CoreDebug;
+
+// The initial stack pointer at the start of the vector table, from start.S.
+const uint32_t StackVector[1] = { 0x20004000U };
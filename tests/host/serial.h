@@ -0,0 +1,43 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef TESTS_HOST_SERIAL_H
+#define TESTS_HOST_SERIAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+	uint32_t Received;
+	uint32_t Sent;
+	// Bytes lost because the handler still held the previous one when the
+	// next had fully arrived.
+	uint32_t Overruns;
+} HOST_SerialStats_t;
+
+extern HOST_SerialStats_t HOST_SerialStats;
+
+// Line rate of the programming cable, 8N1. UART_Init() sets it too.
+void HOST_SerialSetBaud(uint32_t Baud);
+uint64_t HOST_SerialByteTime(void);
+// Clocks Size bytes in back to back from now and runs HandlerUSART1 for each
+// one as its stop bit ends.
+void HOST_SerialReceive(const void *pData, size_t Size);
+// Bytes the firmware sent since the last call, up to Size of them.
+size_t HOST_SerialTake(void *pData, size_t Size);
+void HOST_SerialReset(void);
+
+#endif
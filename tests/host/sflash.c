@@ -0,0 +1,217 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+// SPI NOR flash on the pins driver/serial-flash.c bit-bangs. The firmware
+// names the pins from its own side, it drives SF_MISO and samples SF_MOSI.
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "clock.h"
+#include "driver/pins.h"
+#include "gpio.h"
+#include "sflash.h"
+
+HOST_SflashStats_t HOST_SflashStats;
+uint64_t HOST_SflashProgramTime = HOST_SFLASH_PROGRAM_NS;
+uint64_t HOST_SflashEraseTime = HOST_SFLASH_ERASE_NS;
+
+static uint8_t *pImage;
+static int Fd = -1;
+
+static bool bSelected;
+static bool bClock;
+static uint8_t BitCount;
+static uint8_t ShiftIn;
+static uint8_t ShiftOut;
+static uint16_t ByteCount;
+static uint8_t Command;
+static uint32_t Address;
+static bool bWriteEnabled;
+static uint64_t BusyUntil;
+
+static uint8_t PageBuffer[256];
+static uint16_t PageLength;
+
+static bool IsBusy(void)
+{
+	return HOST_Time < BusyUntil;
+}
+
+// Returns the byte to shift out next.
+static uint8_t HandleByte(uint8_t Data)
+{
+	if (ByteCount == 0) {
+		Command = Data;
+		Address = 0;
+		PageLength = 0;
+		if (IsBusy() && Command != 0x05) {
+			HOST_SflashStats.Errors++;
+			Command = 0x00;
+		}
+		switch (Command) {
+		case 0x06:
+			bWriteEnabled = true;
+			break;
+		case 0x04:
+			bWriteEnabled = false;
+			break;
+		}
+		if (Command != 0x05) {
+			return 0xFF;
+		}
+	}
+
+	switch (Command) {
+	case 0x05:
+		// The status register repeats for as long as CS stays low.
+		return (IsBusy() ? 0x01 : 0x00) | (bWriteEnabled ? 0x02 : 0x00);
+
+	case 0x02:
+	case 0x03:
+	case 0x20:
+		if (ByteCount <= 3) {
+			Address = (Address << 8) | Data;
+			if (ByteCount == 3 && Command == 0x03) {
+				HOST_SflashStats.Reads++;
+				return pImage[Address++ % HOST_SFLASH_SIZE];
+			}
+			return 0xFF;
+		}
+		if (Command == 0x03) {
+			return pImage[Address++ % HOST_SFLASH_SIZE];
+		}
+		if (Command == 0x02 && PageLength < sizeof(PageBuffer)) {
+			PageBuffer[PageLength++] = Data;
+		}
+		return 0xFF;
+	}
+
+	return 0xFF;
+}
+
+// Program and erase start when CS goes high, as on the chip.
+static void EndCommand(void)
+{
+	uint16_t i;
+
+	if (ByteCount < 4 || (Command != 0x02 && Command != 0x20)) {
+		return;
+	}
+	if (!bWriteEnabled) {
+		HOST_SflashStats.Errors++;
+		return;
+	}
+	bWriteEnabled = false;
+	Address %= HOST_SFLASH_SIZE;
+	if (Command == 0x20) {
+		memset(pImage + (Address & ~0xFFFU), 0xFF, 0x1000);
+		BusyUntil = HOST_Time + HOST_SflashEraseTime;
+		HOST_SflashStats.Erases++;
+		return;
+	}
+	if ((Address & 0xFF) + PageLength > 0x100) {
+		HOST_SflashStats.Errors++;
+	}
+	for (i = 0; i < PageLength; i++) {
+		// Programming only clears bits, the page wraps like on the chip.
+		pImage[(Address & ~0xFFU) | ((Address + i) & 0xFFU)] &= PageBuffer[i];
+	}
+	BusyUntil = HOST_Time + HOST_SflashProgramTime;
+	HOST_SflashStats.Programs++;
+}
+
+static void FollowBus(void)
+{
+	const bool bCs = HOST_GpioOutput(GPIOB, BOARD_GPIOB_SF_CS);
+	const bool bClk = HOST_GpioOutput(GPIOB, BOARD_GPIOB_SF_CLK);
+
+	if (bCs) {
+		if (bSelected) {
+			bSelected = false;
+			EndCommand();
+		}
+		bClock = bClk;
+		return;
+	}
+	if (!bSelected) {
+		bSelected = true;
+		BitCount = 0;
+		ByteCount = 0;
+		ShiftOut = 0xFF;
+	}
+	if (bClk && !bClock) {
+		// Mode 0: sample on the rising edge, the output bit is already there.
+		ShiftIn = (ShiftIn << 1) | HOST_GpioOutput(GPIOB, BOARD_GPIOB_SF_MISO);
+		HOST_GpioDrive(GPIOA, BOARD_GPIOA_SF_MOSI, ShiftOut & (0x80U >> BitCount));
+		if (++BitCount == 8) {
+			ShiftOut = HandleByte(ShiftIn);
+			ByteCount++;
+			BitCount = 0;
+		}
+	}
+	bClock = bClk;
+}
+
+bool HOST_SflashOpen(const char *pPath)
+{
+	bool bNew;
+
+	Fd = open(pPath, O_RDWR | O_CREAT, 0644);
+	if (Fd < 0) {
+		return false;
+	}
+	bNew = lseek(Fd, 0, SEEK_END) < (off_t)HOST_SFLASH_SIZE;
+	if (bNew && ftruncate(Fd, HOST_SFLASH_SIZE) != 0) {
+		close(Fd);
+		return false;
+	}
+	pImage = mmap(NULL, HOST_SFLASH_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, Fd, 0);
+	if (pImage == MAP_FAILED) {
+		close(Fd);
+		return false;
+	}
+	if (bNew) {
+		memset(pImage, 0xFF, HOST_SFLASH_SIZE);
+	}
+	memset(&HOST_SflashStats, 0, sizeof(HOST_SflashStats));
+	HOST_SflashProgramTime = HOST_SFLASH_PROGRAM_NS;
+	HOST_SflashEraseTime = HOST_SFLASH_ERASE_NS;
+	bSelected = false;
+	bWriteEnabled = false;
+	BusyUntil = 0;
+	HOST_GpioListen(FollowBus);
+
+	return true;
+}
+
+void HOST_SflashClose(void)
+{
+	if (pImage) {
+		munmap(pImage, HOST_SFLASH_SIZE);
+		pImage = NULL;
+	}
+	if (Fd >= 0) {
+		close(Fd);
+		Fd = -1;
+	}
+}
+
+uint8_t *HOST_SflashImage(void)
+{
+	return pImage;
+}
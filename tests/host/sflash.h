@@ -0,0 +1,53 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef TESTS_HOST_SFLASH_H
+#define TESTS_HOST_SFLASH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// 32 Mbit part, the firmware keeps its tables up to 0x3FFFFF.
+#define HOST_SFLASH_SIZE	0x400000U
+
+// Datasheet typical times of a W25Q32 class part.
+#define HOST_SFLASH_PROGRAM_NS	700000U
+#define HOST_SFLASH_ERASE_NS	45000000U
+
+typedef struct {
+	uint32_t Reads;
+	uint32_t Programs;
+	uint32_t Erases;
+	// Commands the chip would have ignored: busy, write not enabled, or a
+	// page program that crossed a page.
+	uint32_t Errors;
+} HOST_SflashStats_t;
+
+extern HOST_SflashStats_t HOST_SflashStats;
+
+// Busy times of the next program and erase, reset to the typical ones by
+// HOST_SflashOpen(). Tests that erase hundreds of sectors shorten them, the
+// firmware polls the status register for the whole time.
+extern uint64_t HOST_SflashProgramTime;
+extern uint64_t HOST_SflashEraseTime;
+
+// Maps pPath as the flash contents, creating it erased if it does not exist,
+// and starts following the bit-banged bus.
+bool HOST_SflashOpen(const char *pPath);
+void HOST_SflashClose(void);
+uint8_t *HOST_SflashImage(void);
+
+#endif
@@ -0,0 +1,165 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+// Replaces driver/uart.c. Received bytes go through the USART1 register block
+// into the real HandlerUSART1, sent bytes are captured at the driver calls.
+
+#include <string.h>
+#include "app/uart.h"
+#include "clock.h"
+#include "driver/uart.h"
+#include "serial.h"
+
+void HandlerUSART1(void);
+
+HOST_SerialStats_t HOST_SerialStats;
+
+static uint32_t Baud = 115200;
+static uint8_t Output[4096];
+static size_t OutputLength;
+
+static void Capture(uint8_t Data)
+{
+	if (OutputLength < sizeof(Output)) {
+		Output[OutputLength++] = Data;
+	}
+	HOST_SerialStats.Sent++;
+}
+
+void HOST_SerialSetBaud(uint32_t Rate)
+{
+	Baud = Rate;
+}
+
+uint64_t HOST_SerialByteTime(void)
+{
+	return (10ULL * 1000000000ULL) / Baud;
+}
+
+void HOST_SerialReceive(const void *pData, size_t Size)
+{
+	const uint8_t *pBytes = (const uint8_t *)pData;
+	const uint64_t ByteTime = HOST_SerialByteTime();
+	uint64_t Arrival = HOST_Time;
+	size_t i;
+
+	for (i = 0; i < Size; i++) {
+		Arrival += ByteTime;
+		if (HOST_Time >= Arrival + ByteTime && i + 1 < Size) {
+			// The next byte is complete too, this one was overwritten.
+			HOST_SerialStats.Overruns++;
+			continue;
+		}
+		HOST_RunUntil(Arrival);
+		HOST_USART1.dt = pBytes[i];
+		HOST_USART1.sts |= USART_RDBF_FLAG;
+		HandlerUSART1();
+		HOST_USART1.sts &= ~USART_RDBF_FLAG;
+		HOST_SerialStats.Received++;
+		HOST_DeliverPending();
+	}
+}
+
+size_t HOST_SerialTake(void *pData, size_t Size)
+{
+	if (Size > OutputLength) {
+		Size = OutputLength;
+	}
+	memcpy(pData, Output, Size);
+	memmove(Output, Output + Size, OutputLength - Size);
+	OutputLength -= Size;
+
+	return Size;
+}
+
+void HOST_SerialReset(void)
+{
+	OutputLength = 0;
+	memset(&HOST_SerialStats, 0, sizeof(HOST_SerialStats));
+}
+
+void UART_Init(uint32_t BaudRate)
+{
+	Baud = BaudRate;
+	HOST_USART1.ctrl1_bit.ren = TRUE;
+	HOST_USART1.ctrl1_bit.ten = TRUE;
+	HOST_USART1.ctrl1_bit.rdbfien = TRUE;
+	HOST_USART1.ctrl1_bit.uen = TRUE;
+	HOST_USART1.sts = USART_TDBE_FLAG;
+}
+
+// Blocks for the whole byte, like the driver waiting on TDBE.
+void UART_SendByte(uint8_t Data)
+{
+	Capture(Data);
+	HOST_Spend(HOST_SerialByteTime());
+}
+
+void UART_Send(const void *pBuffer, uint8_t Size)
+{
+	const uint8_t *pBytes = (const uint8_t *)pBuffer;
+	uint8_t i;
+
+	for (i = 0; i < Size; i++) {
+		UART_SendByte(pBytes[i]);
+	}
+}
+
+static uint8_t FrameSum(uint8_t Type, const uint8_t *pBytes, uint8_t Size)
+{
+	uint8_t Sum = Type;
+	uint8_t i;
+
+	for (i = 0; i < Size; i++) {
+		Sum += pBytes[i];
+	}
+
+	return Sum;
+}
+
+void UART_SendFrame(uint8_t Type, const void *pData, uint8_t Size)
+{
+	UART_SendByte(Type);
+	UART_Send(pData, Size);
+	UART_SendByte(FrameSum(Type, pData, Size));
+}
+
+uint8_t UART_BuildFrame(uint8_t *pFrame, uint8_t Type, const void *pData, uint8_t Size)
+{
+	pFrame[0] = Type;
+	memcpy(pFrame + 1, pData, Size);
+	pFrame[Size + 1] = FrameSum(Type, pData, Size);
+
+	return Size + 2;
+}
+
+// The queue drains in the background on the chip, so it costs no CPU time.
+bool UART_Queue(const void *pBuffer, uint8_t Size)
+{
+	const uint8_t *pBytes = (const uint8_t *)pBuffer;
+	uint8_t i;
+
+	for (i = 0; i < Size; i++) {
+		Capture(pBytes[i]);
+	}
+
+	return true;
+}
+
+void UART_HandleTX(void)
+{
+	HOST_USART1.ctrl1_bit.tdbeien = FALSE;
+}
@@ -0,0 +1,308 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+// BK4819 bus transactions and virtual time per operation of the radio code,
+// the numbers to compare before and after a change to the register traffic.
+// Bus time is what the transfers alone take at BK4819_SCL_HZ, total time
+// includes everything else the operation did, drawing included.
+
+#include <stdio.h>
+#include "app/css.h"
+#include "app/radio.h"
+#include "app/spectrum.h"
+#include "driver/pins.h"
+#include "fixture.h"
+#include "host/bk4819.h"
+#include "host/check.h"
+#include "host/clock.h"
+#include "host/gpio.h"
+#include "misc.h"
+#include "radio/detector.h"
+#include "radio/scheduler.h"
+#include "radio/settings.h"
+#include "task/am-fix.h"
+#include "task/incoming.h"
+#include "task/rssi.h"
+#include "task/spectrum.h"
+
+#define IMAGE "build/bk4819_bench.img"
+
+#define SCAN_FREQUENCY	44610000U
+#define VHF_FREQUENCY	14550000U
+
+unsigned int HOST_Failures;
+
+typedef struct {
+	uint64_t Time;
+	uint32_t Reads;
+	uint32_t Writes;
+	uint32_t Count;
+} Totals_t;
+
+static HOST_BK4819Signal_t Signal;
+static uint32_t Frequency;
+
+static void OnAir(uint32_t SignalFrequency, int16_t Level)
+{
+	Signal = (HOST_BK4819Signal_t){ .Frequency = SignalFrequency, .Level = Level };
+	HOST_BK4819SetSignals(&Signal, 1);
+}
+
+static void Measure(Totals_t *pTotals, void (*pOperation)(void))
+{
+	const uint64_t Start = HOST_Time;
+	const uint32_t Reads = HOST_BK4819Stats.Reads;
+	const uint32_t Writes = HOST_BK4819Stats.Writes;
+
+	pOperation();
+
+	pTotals->Time += HOST_Time - Start;
+	pTotals->Reads += HOST_BK4819Stats.Reads - Reads;
+	pTotals->Writes += HOST_BK4819Stats.Writes - Writes;
+	pTotals->Count++;
+}
+
+static void Report(const char *pName, const Totals_t *pTotals)
+{
+	const double Count = pTotals->Count ? pTotals->Count : 1;
+
+	printf("%-24s %6u %7.1f %7.1f %9.1f %9.1f\n",
+		pName,
+		pTotals->Count,
+		pTotals->Reads / Count,
+		pTotals->Writes / Count,
+		((pTotals->Reads + pTotals->Writes) * HOST_BK4819_ACCESS_NS) / 1000.0 / Count,
+		pTotals->Time / 1000.0 / Count);
+}
+
+static void RunReceiver(uint32_t Milliseconds)
+{
+	uint32_t i;
+
+	for (i = 0; i < Milliseconds; i++) {
+		FIXTURE_Wait(1);
+		Task_CheckIncoming();
+		Task_CheckRSSI();
+	}
+}
+
+static void TuneCurrent(void)
+{
+	RADIO_Tune(gCurrentVfo);
+}
+
+static void TuneOther(void)
+{
+	RADIO_Tune(!gCurrentVfo);
+}
+
+static void FastTune(void)
+{
+	RADIO_FastTune(Frequency);
+}
+
+static void BenchTune(void)
+{
+	Totals_t Same = { 0 };
+	Totals_t Vfo = { 0 };
+	Totals_t Band = { 0 };
+	Totals_t Step = { 0 };
+	Totals_t Jump = { 0 };
+	uint8_t i;
+
+	FIXTURE_Boot(IMAGE);
+
+	for (i = 0; i < 10; i++) {
+		Measure(&Same, TuneCurrent);
+		Measure(&Vfo, TuneOther);
+	}
+	Report("RADIO_Tune unchanged", &Same);
+	Report("RADIO_Tune other VFO", &Vfo);
+
+	gVfoState[1].RX.Frequency = VHF_FREQUENCY;
+	gVfoState[1].TX.Frequency = VHF_FREQUENCY;
+	for (i = 0; i < 10; i++) {
+		Measure(&Band, TuneOther);
+	}
+	Report("RADIO_Tune other band", &Band);
+
+	Frequency = gVfoInfo[gCurrentVfo].Frequency;
+	for (i = 0; i < 100; i++) {
+		Frequency += 1250;
+		Measure(&Step, FastTune);
+	}
+	Report("RADIO_FastTune 12.5 kHz", &Step);
+
+	for (i = 0; i < 10; i++) {
+		Frequency = (i & 1) ? SCAN_FREQUENCY : VHF_FREQUENCY;
+		Measure(&Jump, FastTune);
+	}
+	Report("RADIO_FastTune band", &Jump);
+
+	FIXTURE_Teardown();
+}
+
+static void BenchReceive(void)
+{
+	Totals_t Start = { 0 };
+	Totals_t End = { 0 };
+	Totals_t Rssi = { 0 };
+	uint8_t i;
+
+	FIXTURE_Boot(IMAGE);
+
+	OnAir(gVfoInfo[gCurrentVfo].Frequency, -90);
+	for (i = 0; i < 10; i++) {
+		gRadioMode = RADIO_MODE_RX;
+		Measure(&Start, RADIO_StartRX);
+		FIXTURE_Wait(100);
+		Measure(&End, RADIO_EndRX);
+		FIXTURE_Wait(100);
+	}
+	Report("RADIO_StartRX", &Start);
+	Report("RADIO_EndRX", &End);
+
+	RunReceiver(50);
+	CHECK_EQUAL(gRadioMode, RADIO_MODE_RX);
+	for (i = 0; i < 200; i++) {
+		FIXTURE_Wait(2);
+		Measure(&Rssi, Task_CheckRSSI);
+	}
+	Report("Task_CheckRSSI in RX", &Rssi);
+
+	FIXTURE_Teardown();
+}
+
+static void BenchAmFix(void)
+{
+	Totals_t Am = { 0 };
+	Totals_t Fm = { 0 };
+	uint8_t i;
+
+	FIXTURE_Boot(IMAGE);
+
+	OnAir(gVfoInfo[gCurrentVfo].Frequency, -50);
+	RunReceiver(50);
+	CHECK_EQUAL(gRadioMode, RADIO_MODE_RX);
+
+	gVfoState[gSettings.CurrentVfo].gModulationType = 1;
+	for (i = 0; i < 50; i++) {
+		FIXTURE_Wait(100);
+		Measure(&Am, Task_AM_fix);
+	}
+	Report("Task_AM_fix AM", &Am);
+
+	gVfoState[gSettings.CurrentVfo].gModulationType = 0;
+	for (i = 0; i < 20; i++) {
+		FIXTURE_Wait(1000);
+		Measure(&Fm, Task_AM_fix);
+	}
+	Report("Task_AM_fix FM", &Fm);
+
+	FIXTURE_Teardown();
+}
+
+// One measured bin per RSSI read, the settle time between bins included.
+static void BenchSpectrum(void)
+{
+	Totals_t Start = { 0 };
+	Totals_t Bins = { 0 };
+	uint64_t Begin;
+	uint32_t Reads;
+	uint32_t Writes;
+
+	FIXTURE_Boot(IMAGE);
+
+	Measure(&Start, APP_Spectrum);
+	Report("APP_Spectrum", &Start);
+
+	Begin = HOST_Time;
+	Reads = HOST_BK4819Stats.Reads;
+	Writes = HOST_BK4819Stats.Writes;
+	while (HOST_BK4819Stats.RegReads[0x67] < 512) {
+		FIXTURE_Wait(1);
+		Task_Spectrum();
+	}
+	Bins.Count = HOST_BK4819Stats.RegReads[0x67];
+	Bins.Reads = HOST_BK4819Stats.Reads - Reads;
+	Bins.Writes = HOST_BK4819Stats.Writes - Writes;
+	Bins.Time = HOST_Time - Begin;
+	Report("Task_Spectrum per bin", &Bins);
+
+	gScreenMode = SCREEN_MAIN;
+	FIXTURE_Teardown();
+}
+
+static struct {
+	uint64_t Start;
+	uint64_t CarrierTime;
+	uint64_t CodeTime;
+	uint32_t CarrierAccesses;
+	uint32_t CodeAccesses;
+} Detector;
+
+// Polls what the detector found every ms, and presses PTT to leave it once
+// it has the code or gave up.
+static void WatchDetector(void)
+{
+	const ChannelInfo_t *pVfo = &gVfoState[gSettings.CurrentVfo];
+	const uint32_t Accesses = HOST_BK4819Stats.Reads + HOST_BK4819Stats.Writes;
+
+	if (!Detector.CarrierTime && pVfo->RX.Frequency == SCAN_FREQUENCY) {
+		Detector.CarrierTime = HOST_Time - Detector.Start;
+		Detector.CarrierAccesses = Accesses;
+	}
+	if (!Detector.CodeTime && pVfo->RX.CodeType != CODE_TYPE_OFF) {
+		Detector.CodeTime = HOST_Time - Detector.Start;
+		Detector.CodeAccesses = Accesses;
+	}
+	if (Detector.CodeTime || HOST_Time - Detector.Start > 5000000000ULL) {
+		HOST_GpioDrive(GPIOB, BOARD_GPIOB_KEY_PTT, false);
+		return;
+	}
+	HOST_At(HOST_Time + 1000000U, WatchDetector);
+}
+
+static void BenchDetector(void)
+{
+	FIXTURE_Boot(IMAGE);
+
+	OnAir(SCAN_FREQUENCY, -60);
+	Signal.Ctcss = 885;
+	Detector.Start = HOST_Time;
+	HOST_At(HOST_Time + 1000000U, WatchDetector);
+	RADIO_FrequencyDetect();
+	HOST_GpioDrive(GPIOB, BOARD_GPIOB_KEY_PTT, true);
+
+	CHECK(Detector.CarrierTime != 0);
+	CHECK(Detector.CodeTime != 0);
+	printf("detector carrier found %9.1f ms %6u transactions\n", Detector.CarrierTime / 1e6, Detector.CarrierAccesses);
+	printf("detector CTCSS found   %9.1f ms %6u transactions\n", Detector.CodeTime / 1e6, Detector.CodeAccesses);
+
+	FIXTURE_Teardown();
+}
+
+int main(void)
+{
+	printf("operation                 calls   reads  writes    bus us  total us\n");
+	BenchTune();
+	BenchReceive();
+	BenchAmFix();
+	BenchSpectrum();
+	BenchDetector();
+
+	return HOST_Failures ? 1 : 0;
+}
@@ -0,0 +1,369 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+// The register traffic of the radio code against the BK4819 model: what
+// the firmware writes ends up in the right registers, and what it reads back
+// from the status and result registers follows the signals on the air.
+
+#include <stdio.h>
+#include "app/css.h"
+#include "app/radio.h"
+#include "driver/bk4819.h"
+#include "driver/pins.h"
+#include "fixture.h"
+#include "host/bk4819.h"
+#include "host/check.h"
+#include "host/clock.h"
+#include "host/gpio.h"
+#include "misc.h"
+#include "radio/detector.h"
+#include "radio/frequencies.h"
+#include "radio/scheduler.h"
+#include "radio/settings.h"
+#include "task/incoming.h"
+#include "task/rssi.h"
+
+#define IMAGE "build/bk4819_test.img"
+
+// Clear of the VFO defaults and a multiple of 1 kHz, so the scan result
+// converts back to it exactly.
+#define SCAN_FREQUENCY	44610000U
+
+unsigned int HOST_Failures;
+
+static HOST_BK4819Signal_t Signal;
+
+static void OnAir(uint32_t Frequency, int16_t Level)
+{
+	Signal = (HOST_BK4819Signal_t){ .Frequency = Frequency, .Level = Level };
+	HOST_BK4819SetSignals(&Signal, 1);
+}
+
+static uint32_t Tuned(void)
+{
+	return gVfoInfo[gCurrentVfo].Frequency;
+}
+
+// BK4819_GetStatus() reads 0x0C once per tick.
+static bool SquelchOpen(void)
+{
+	FIXTURE_Wait(1);
+
+	return BK4819_CheckSquelchLink();
+}
+
+static void RunReceiver(uint32_t Milliseconds)
+{
+	uint32_t i;
+
+	for (i = 0; i < Milliseconds; i++) {
+		FIXTURE_Wait(1);
+		Task_CheckIncoming();
+		Task_CheckRSSI();
+	}
+}
+
+static void TestBootTunesVfo(void)
+{
+	FIXTURE_Boot(IMAGE);
+
+	CHECK_EQUAL(HOST_BK4819Frequency(), Tuned());
+	CHECK_EQUAL(HOST_BK4819Peek(0x37), 0x1F0F);
+	CHECK_EQUAL(HOST_BK4819Peek(0x30), 0xBFF1);
+	CHECK_EQUAL(gRadioMode, RADIO_MODE_QUIET);
+
+	FIXTURE_Teardown();
+}
+
+static void TestRssiFollowsSignals(void)
+{
+	HOST_BK4819Signal_t Signals[2];
+
+	FIXTURE_Boot(IMAGE);
+
+	CHECK_EQUAL(BK4819_GetRSSI(), (HOST_BK4819_NOISE_FLOOR + 160) * 2);
+
+	OnAir(Tuned(), -80);
+	CHECK_EQUAL(BK4819_GetRSSI(), (-80 + 160) * 2);
+	CHECK(BK4819_GetNoise() < 10);
+
+	// Moved a channel away, the model keeps the pointer.
+	Signal.Frequency += 2500;
+	CHECK_EQUAL(BK4819_GetRSSI(), (HOST_BK4819_NOISE_FLOOR + 160) * 2);
+
+	Signals[0] = (HOST_BK4819Signal_t){ .Frequency = Tuned(), .Level = -100 };
+	Signals[1] = (HOST_BK4819Signal_t){ .Frequency = Tuned() + 500, .Level = -70 };
+	HOST_BK4819SetSignals(Signals, 2);
+	CHECK_EQUAL(BK4819_GetRSSI(), (-70 + 160) * 2);
+
+	FIXTURE_Teardown();
+}
+
+// The image opens the squelch at about -112 dBm and closes it under about
+// -121 dBm, from the thresholds the firmware puts in 0x78 and 0x4F.
+static void TestSquelchHysteresis(void)
+{
+	FIXTURE_Boot(IMAGE);
+
+	OnAir(Tuned(), -118);
+	CHECK(!SquelchOpen());
+	Signal.Level = -105;
+	CHECK(SquelchOpen());
+	Signal.Level = -118;
+	CHECK(SquelchOpen());
+	Signal.Level = -125;
+	CHECK(!SquelchOpen());
+	Signal.Level = -118;
+	CHECK(!SquelchOpen());
+
+	FIXTURE_Teardown();
+}
+
+static void TestCarrierOpensReceiver(void)
+{
+	FIXTURE_Boot(IMAGE);
+
+	OnAir(Tuned(), -90);
+	RunReceiver(50);
+	CHECK_EQUAL(gRadioMode, RADIO_MODE_RX);
+	CHECK(HOST_BK4819Peek(0x47) != (0x6040 | (BK4819_AF_MUTE << 8)));
+
+	Signal.Level = HOST_BK4819_NOISE_FLOOR;
+	RunReceiver(50);
+	CHECK_EQUAL(gRadioMode, RADIO_MODE_QUIET);
+	CHECK_EQUAL(HOST_BK4819Peek(0x47), 0x6040 | (BK4819_AF_MUTE << 8));
+
+	FIXTURE_Teardown();
+}
+
+static void TestCtcss(void)
+{
+	uint16_t Result;
+
+	FIXTURE_Boot(IMAGE);
+
+	CSS_SetStandardCode(CODE_TYPE_CTCSS, 885, 0, false);
+	OnAir(Tuned(), -80);
+	Signal.Ctcss = 885;
+	FIXTURE_Wait(1);
+	CHECK(BK4819_GetStatus() & 0x0400U);
+
+	// Decoded the way the detector does it.
+	Result = BK4819_ReadRegister(0x68);
+	CHECK(!(Result & 0x8000U));
+	CHECK_EQUAL((((Result & 0xFFFU) * 200U) / 412U) + 1U, 885);
+
+	Signal.Ctcss = 1000;
+	FIXTURE_Wait(1);
+	CHECK(!(BK4819_GetStatus() & 0x0400U));
+
+	Signal.Ctcss = 0;
+	Signal.bTailTone = true;
+	FIXTURE_Wait(1);
+	CHECK(BK4819_GetStatus() & 0x0800U);
+	CHECK(BK4819_ReadRegister(0x68) & 0x8000U);
+
+	FIXTURE_Teardown();
+}
+
+static void TestDcs(void)
+{
+	const uint16_t Code = DCS_GetOption(6);
+	const uint32_t Golay = CSS_CalculateGolay(Code + 0x800) & 0x7FFFFFU;
+	uint32_t Result;
+
+	FIXTURE_Boot(IMAGE);
+
+	CSS_SetStandardCode(CODE_TYPE_DCS_N, Code, 0, false);
+	OnAir(Tuned(), -80);
+	Signal.Golay = Golay;
+	FIXTURE_Wait(1);
+	CHECK_EQUAL(BK4819_GetStatus() & 0xC000U, 0x4000U);
+
+	Result = BK4819_ReadRegister(0x69);
+	CHECK(!(Result & 0x8000U));
+	Result = ((Result & 0xFFFU) << 12) | (BK4819_ReadRegister(0x6A) & 0xFFFU);
+	CHECK_EQUAL(Result, Golay);
+
+	Signal.Golay = ~Golay & 0x7FFFFFU;
+	FIXTURE_Wait(1);
+	CHECK_EQUAL(BK4819_GetStatus() & 0xC000U, 0x8000U);
+
+	Signal.Golay = 0;
+	CHECK(BK4819_ReadRegister(0x69) & 0x8000U);
+
+	FIXTURE_Teardown();
+}
+
+static void TestFrequencyScan(void)
+{
+	uint32_t Frequency;
+	uint16_t Result;
+
+	FIXTURE_Boot(IMAGE);
+
+	gUseUhfFilter = true;
+	BK4819_EnableFilter(true);
+	OnAir(SCAN_FREQUENCY, -60);
+	BK4819_StartFrequencyScan();
+	CHECK(BK4819_ReadRegister(0x0D) & 0x8000U);
+
+	FIXTURE_Wait(HOST_BK4819_SCAN_NS / 1000000U);
+	Result = BK4819_ReadRegister(0x0D);
+	CHECK(!(Result & 0x8000U));
+	Frequency = ((Result & 0x07FFU) << 16) | BK4819_ReadRegister(0x0E);
+
+	// Close call converts with the VFO still on its own band.
+	FREQUENCY_SelectBand(14500000);
+	gUseUhfFilter = true;
+	CHECK_EQUAL(RADIO_ScanToFrequency(Frequency, false), SCAN_FREQUENCY);
+	CHECK_EQUAL(gCurrentFrequencyBand, BAND_136MHz);
+	CHECK(gUseUhfFilter);
+
+	CHECK_EQUAL(RADIO_ConvertScanFrequency(Frequency, false), SCAN_FREQUENCY);
+	CHECK_EQUAL(gCurrentFrequencyBand, BAND_400MHz);
+
+	// Too weak to lock onto.
+	BK4819_StopFrequencyScan();
+	Signal.Level = HOST_BK4819_SCAN_LEVEL - 1;
+	BK4819_StartFrequencyScan();
+	FIXTURE_Wait(2 * HOST_BK4819_SCAN_NS / 1000000U);
+	CHECK(BK4819_ReadRegister(0x0D) & 0x8000U);
+	BK4819_StopFrequencyScan();
+
+	FIXTURE_Teardown();
+}
+
+static void TestLogTimestamps(void)
+{
+	const HOST_BK4819Access_t *pLog;
+	size_t Count;
+	size_t i;
+
+	FIXTURE_Boot(IMAGE);
+
+	RADIO_FastTune(Tuned() + 2500);
+	pLog = HOST_BK4819Log(&Count);
+	CHECK(Count > 0);
+	CHECK_EQUAL(Count, HOST_BK4819Stats.Reads + HOST_BK4819Stats.Writes);
+	for (i = 1; i < Count; i++) {
+		CHECK(pLog[i].Time - pLog[i - 1].Time >= HOST_BK4819_ACCESS_NS);
+	}
+	CHECK(pLog[Count - 1].Time <= HOST_Time);
+	CHECK_EQUAL(HOST_BK4819Stats.RegWrites[0x38], 1);
+	CHECK_EQUAL(HOST_BK4819Frequency(), Tuned() + 2500);
+
+	HOST_BK4819ClearLog();
+	HOST_BK4819Log(&Count);
+	CHECK_EQUAL(Count, 0);
+	CHECK_EQUAL(HOST_BK4819Stats.Writes, 0);
+
+	FIXTURE_Teardown();
+}
+
+// Registers only the firmware changes are read from the shadow, status ones
+// always from the chip, and writes of an unchanged value are dropped.
+static void TestShadowedAccesses(void)
+{
+	FIXTURE_Boot(IMAGE);
+
+	BK4819_ReadRegister(0x30);
+	BK4819_ReadRegister(0x30);
+	CHECK_EQUAL(HOST_BK4819Stats.RegReads[0x30], 0);
+
+	BK4819_GetRSSI();
+	BK4819_GetRSSI();
+	CHECK_EQUAL(HOST_BK4819Stats.RegReads[0x67], 2);
+
+	RADIO_Tune(gCurrentVfo);
+	CHECK_EQUAL(HOST_BK4819Stats.RegWrites[0x38], 0);
+	CHECK_EQUAL(HOST_BK4819Stats.RegWrites[0x39], 0);
+	CHECK_EQUAL(HOST_BK4819Stats.RegWrites[0x78], 0);
+
+	FIXTURE_Teardown();
+}
+
+static struct {
+	uint32_t Frequency;
+	uint16_t Code;
+	uint8_t CodeType;
+} Detected;
+
+static void ReleaseDetector(void)
+{
+	const ChannelInfo_t *pVfo = &gVfoState[gSettings.CurrentVfo];
+
+	Detected.Frequency = pVfo->RX.Frequency;
+	Detected.Code = pVfo->RX.Code;
+	Detected.CodeType = pVfo->RX.CodeType;
+	HOST_GpioDrive(GPIOB, BOARD_GPIOB_KEY_PTT, false);
+}
+
+// Runs the blocking detector for Milliseconds, then presses PTT to leave it
+// and keeps what it found before leaving reloads the VFO.
+static void Detect(uint32_t Milliseconds)
+{
+	HOST_At(HOST_Time + Milliseconds * 1000000ULL, ReleaseDetector);
+	RADIO_FrequencyDetect();
+	HOST_GpioDrive(GPIOB, BOARD_GPIOB_KEY_PTT, true);
+}
+
+static void TestDetectorFindsCtcss(void)
+{
+	FIXTURE_Boot(IMAGE);
+
+	OnAir(SCAN_FREQUENCY, -60);
+	Signal.Ctcss = 885;
+	Detect(2000);
+	CHECK_EQUAL(Detected.Frequency, SCAN_FREQUENCY);
+	CHECK_EQUAL(Detected.CodeType, CODE_TYPE_CTCSS);
+	CHECK_EQUAL(Detected.Code, 885);
+
+	FIXTURE_Teardown();
+}
+
+static void TestDetectorFindsDcs(void)
+{
+	const uint16_t Code = DCS_GetOption(6);
+
+	FIXTURE_Boot(IMAGE);
+
+	OnAir(SCAN_FREQUENCY, -60);
+	Signal.Golay = CSS_CalculateGolay(Code + 0x800) & 0x7FFFFFU;
+	Detect(2000);
+	CHECK_EQUAL(Detected.Frequency, SCAN_FREQUENCY);
+	CHECK_EQUAL(Detected.CodeType, CODE_TYPE_DCS_N);
+	CHECK_EQUAL(Detected.Code, Code);
+
+	FIXTURE_Teardown();
+}
+
+int main(void)
+{
+	RUN(TestBootTunesVfo);
+	RUN(TestRssiFollowsSignals);
+	RUN(TestSquelchHysteresis);
+	RUN(TestCarrierOpensReceiver);
+	RUN(TestCtcss);
+	RUN(TestDcs);
+	RUN(TestFrequencyScan);
+	RUN(TestLogTimestamps);
+	RUN(TestShadowedAccesses);
+	RUN(TestDetectorFindsCtcss);
+	RUN(TestDetectorFindsDcs);
+
+	return HOST_Failures ? 1 : 0;
+}
@@ -0,0 +1,63 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+// Links the whole firmware except the startup code with the host drivers, so
+// the register traffic of the radio code can be checked against the BK4819
+// model in host/bk4819.c.
+
+#include <unistd.h>
+#include "app/radio.h"
+#include "driver/delay.h"
+#include "driver/serial-flash.h"
+#include "fixture.h"
+#include "host/bk4819.h"
+#include "host/clock.h"
+#include "host/gpio.h"
+#include "host/image.h"
+#include "host/serial.h"
+#include "host/sflash.h"
+#include "radio/scheduler.h"
+
+void HandlerTMR1_BRK_OVF_TRG_HALL(void);
+
+void FIXTURE_Boot(const char *pImage)
+{
+	unlink(pImage);
+	HOST_GpioReset();
+	HOST_SerialReset();
+	HOST_ResetClock();
+	HOST_BK4819Reset();
+	HOST_SflashOpen(pImage);
+	HOST_ImageFormat(HOST_SflashImage());
+
+	DELAY_Init();
+	SCHEDULER_Init();
+	HOST_SetTickHandler(HandlerTMR1_BRK_OVF_TRG_HALL);
+	SFLASH_Init();
+	RADIO_Init();
+
+	HOST_BK4819ClearLog();
+}
+
+void FIXTURE_Teardown(void)
+{
+	HOST_SflashClose();
+}
+
+void FIXTURE_Wait(uint32_t Milliseconds)
+{
+	HOST_RunUntil(HOST_Time + Milliseconds * 1000000ULL);
+}
@@ -0,0 +1,29 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef TESTS_RADIO_FIXTURE_H
+#define TESTS_RADIO_FIXTURE_H
+
+#include <stdint.h>
+
+// Fresh formatted flash image at pImage, clock at zero, TMR1 ticking into
+// the real scheduler, then the radio part of the boot: RADIO_Init() tunes
+// VFO A. The BK4819 log is cleared on return.
+void FIXTURE_Boot(const char *pImage);
+void FIXTURE_Teardown(void);
+void FIXTURE_Wait(uint32_t Milliseconds);
+
+#endif
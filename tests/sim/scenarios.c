@@ -0,0 +1,151 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+// The scripts shared by sim_test.c, which checks what the firmware did, and
+// sim_bench.c, which reports how long it took.
+
+#include "driver/key.h"
+#include "host/bk4819.h"
+#include "scenarios.h"
+
+#define OFF_AIR	HOST_BK4819_NOISE_FLOOR
+
+static const SIM_Step_t KeypadSteps[] = {
+	{    0, SIM_STEP_KEY, KEY_UP, 0 },
+	{  100, SIM_STEP_KEY, KEY_NONE, 0 },
+	{  500, SIM_STEP_KEY, KEY_UP, 0 },
+	{  600, SIM_STEP_KEY, KEY_NONE, 0 },
+	{ 1000, SIM_STEP_KEY, KEY_DOWN, 0 },
+	{ 1100, SIM_STEP_KEY, KEY_NONE, 0 },
+	{ 1500, SIM_STEP_END, 0, 0 },
+};
+
+const SIM_Scenario_t SCENARIO_Keypad = {
+	.pName = "keypad",
+	.pSteps = KeypadSteps,
+};
+
+static const SIM_Step_t CarrierSteps[] = {
+	{    0, SIM_STEP_CARRIER, SCENARIO_VFO_A, -80 },
+	{ 1000, SIM_STEP_CARRIER, SCENARIO_VFO_A, OFF_AIR },
+	{ 2000, SIM_STEP_END, 0, 0 },
+};
+
+const SIM_Scenario_t SCENARIO_Carrier = {
+	.pName = "carrier",
+	.pSteps = CarrierSteps,
+};
+
+// With squelch level 1 the receiver opens near -112 dBm and closes below
+// about -121 dBm.
+static const SIM_Step_t SquelchSteps[] = {
+	{    0, SIM_STEP_CARRIER, SCENARIO_VFO_A, -125 },
+	{ 1000, SIM_STEP_CARRIER, SCENARIO_VFO_A, -116 },
+	{ 2000, SIM_STEP_CARRIER, SCENARIO_VFO_A, -108 },
+	{ 3000, SIM_STEP_CARRIER, SCENARIO_VFO_A, -116 },
+	{ 4000, SIM_STEP_CARRIER, SCENARIO_VFO_A, -125 },
+	{ 5000, SIM_STEP_END, 0, 0 },
+};
+
+const SIM_Scenario_t SCENARIO_Squelch = {
+	.pName = "squelch",
+	.pSteps = SquelchSteps,
+};
+
+static const SIM_Step_t ScannerSteps[] = {
+	{    0, SIM_STEP_CARRIER, SCENARIO_SCAN_HIT, -80 },
+	{    0, SIM_STEP_KEY, KEY_1, 0 },
+	{ 1200, SIM_STEP_KEY, KEY_NONE, 0 },
+	{ 3000, SIM_STEP_END, 0, 0 },
+};
+
+const SIM_Scenario_t SCENARIO_Scanner = {
+	.pName = "scanner",
+	.pSteps = ScannerSteps,
+};
+
+static void EnableDualWatch(gSettings_t *pSettings)
+{
+	pSettings->DualStandby = 1;
+}
+
+static const SIM_Step_t DualWatchSteps[] = {
+	{ 1000, SIM_STEP_CARRIER, SCENARIO_VFO_B, -80 },
+	{ 2000, SIM_STEP_CARRIER, SCENARIO_VFO_B, OFF_AIR },
+	{ 3000, SIM_STEP_END, 0, 0 },
+};
+
+const SIM_Scenario_t SCENARIO_DualWatch = {
+	.pName = "dualwatch",
+	.pSetup = EnableDualWatch,
+	.pSteps = DualWatchSteps,
+};
+
+static void EnableSaveMode(gSettings_t *pSettings)
+{
+	pSettings->SaveMode = 1;
+}
+
+static const SIM_Step_t SaveModeSteps[] = {
+	{ 5000, SIM_STEP_KEY, KEY_UP, 0 },
+	{ 5100, SIM_STEP_KEY, KEY_NONE, 0 },
+	{ 8000, SIM_STEP_CARRIER, SCENARIO_VFO_A + SCENARIO_STEP, -80 },
+	{ 9000, SIM_STEP_CARRIER, SCENARIO_VFO_A + SCENARIO_STEP, OFF_AIR },
+	{ 10000, SIM_STEP_END, 0, 0 },
+};
+
+const SIM_Scenario_t SCENARIO_SaveMode = {
+	.pName = "savemode",
+	.pSetup = EnableSaveMode,
+	.pSteps = SaveModeSteps,
+};
+
+static void EnableRogerBeep(gSettings_t *pSettings)
+{
+	pSettings->RogerBeep = 2;
+}
+
+// The second press lands while the 180 ms roger beep of the first release
+// is still playing.
+static const SIM_Step_t RogerSteps[] = {
+	{    0, SIM_STEP_PTT, 1, 0 },
+	{ 1000, SIM_STEP_PTT, 0, 0 },
+	{ 1010, SIM_STEP_PTT, 1, 0 },
+	{ 1150, SIM_STEP_PTT, 0, 0 },
+	{ 2000, SIM_STEP_END, 0, 0 },
+};
+
+const SIM_Scenario_t SCENARIO_Roger = {
+	.pName = "roger",
+	.pSetup = EnableRogerBeep,
+	.pSteps = RogerSteps,
+};
+
+static void EnableDisplayTimer(gSettings_t *pSettings)
+{
+	pSettings->SaveMode = 1;
+	pSettings->DisplayTimer = 1;
+}
+
+static const SIM_Step_t DisplayTimerSteps[] = {
+	{ 10000, SIM_STEP_END, 0, 0 },
+};
+
+const SIM_Scenario_t SCENARIO_DisplayTimer = {
+	.pName = "display",
+	.pSetup = EnableDisplayTimer,
+	.pSteps = DisplayTimerSteps,
+};
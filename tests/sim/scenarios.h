@@ -0,0 +1,47 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef TESTS_SIM_SCENARIOS_H
+#define TESTS_SIM_SCENARIOS_H
+
+#include "sim.h"
+
+// The VFOs as the firmware sets them up on an erased image.
+#define SCENARIO_VFO_A	43002500U
+#define SCENARIO_VFO_B	43502500U
+// 25 kHz, FrequencyStep 8 of the image.
+#define SCENARIO_STEP	2500U
+// Where the scanner finds a carrier, four steps above VFO A.
+#define SCENARIO_SCAN_HIT	(SCENARIO_VFO_A + (4 * SCENARIO_STEP))
+
+// UP and DOWN step VFO A, a long press of 1 starts the scanner.
+extern const SIM_Scenario_t SCENARIO_Keypad;
+// A strong carrier on VFO A for a second.
+extern const SIM_Scenario_t SCENARIO_Carrier;
+// A carrier rising through the squelch threshold and back, in 1 s steps.
+extern const SIM_Scenario_t SCENARIO_Squelch;
+// The scanner running up from VFO A onto a carrier at SCENARIO_SCAN_HIT.
+extern const SIM_Scenario_t SCENARIO_Scanner;
+// Dual watch on, then a carrier on VFO B.
+extern const SIM_Scenario_t SCENARIO_DualWatch;
+// Battery save on, quiet for a while, then a key and a carrier.
+extern const SIM_Scenario_t SCENARIO_SaveMode;
+// Roger beep 2 on, PTT pressed again while the beep of the release plays.
+extern const SIM_Scenario_t SCENARIO_Roger;
+// Battery save on and a 5 s display timer, left alone.
+extern const SIM_Scenario_t SCENARIO_DisplayTimer;
+
+#endif
@@ -0,0 +1,358 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+// Runs Main() with every peripheral replaced by the models in host/, in a
+// child per scenario so each one starts from fresh firmware statics. Time is
+// virtual, a run gives the same trace every time and on any host.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "app/radio.h"
+#include "driver/bk4819.h"
+#include "host/bk4819.h"
+#include "host/check.h"
+#include "host/clock.h"
+#include "host/gpio.h"
+#include "host/image.h"
+#include "host/keypad.h"
+#include "host/lcd.h"
+#include "host/serial.h"
+#include "host/sflash.h"
+#include "misc.h"
+#include "sim.h"
+
+#define IMAGE		"build/sim.img"
+#define TRACE_COUNT	16384U
+// Real seconds a child gets before it counts as hung.
+#define WATCHDOG_S	60U
+
+void HandlerTMR1_BRK_OVF_TRG_HALL(void);
+void Main(void) __attribute__((noreturn));
+
+typedef struct {
+	uint32_t RadioMode;
+	uint32_t Frequency;
+	uint32_t Vfo;
+	uint32_t bAudio;
+	uint32_t bScanner;
+	uint32_t ScreenMode;
+	uint32_t Frame;
+	uint32_t Pixels;
+	bool bDrawing;
+} State_t;
+
+static const SIM_Scenario_t *pScenario;
+static const SIM_Step_t *pStep;
+static void (*pEndHandler)(void);
+static const char *pTraceFile;
+static HOST_BK4819Signal_t Carrier;
+static SIM_Trace_t Trace[TRACE_COUNT];
+static size_t TraceCount;
+static State_t Last;
+static SIM_Usage_t Start;
+static int ResultPipe = -1;
+
+static const char *const TypeNames[] = {
+	[SIM_TRACE_STEP] = "step",
+	[SIM_TRACE_RADIO] = "radio",
+	[SIM_TRACE_TUNE] = "tune",
+	[SIM_TRACE_VFO] = "vfo",
+	[SIM_TRACE_AUDIO] = "audio",
+	[SIM_TRACE_SCANNER] = "scanner",
+	[SIM_TRACE_SCREEN] = "screen",
+	[SIM_TRACE_FRAME] = "frame",
+};
+
+static void Record(SIM_TraceType_t Type, uint32_t Value)
+{
+	if (TraceCount < TRACE_COUNT) {
+		Trace[TraceCount].Time = HOST_Time;
+		Trace[TraceCount].Type = Type;
+		Trace[TraceCount].Value = Value;
+		TraceCount++;
+	}
+}
+
+static void Follow(SIM_TraceType_t Type, uint32_t *pLast, uint32_t Value)
+{
+	if (*pLast != Value) {
+		*pLast = Value;
+		Record(Type, Value);
+	}
+}
+
+// Samples what the trace follows. The frame is only hashed once a tick
+// passes without pixels, so a screen drawn across ticks logs once, and only
+// if it looks different.
+static void Observe(void)
+{
+	Follow(SIM_TRACE_RADIO, &Last.RadioMode, gRadioMode);
+	Follow(SIM_TRACE_TUNE, &Last.Frequency, HOST_BK4819Frequency());
+	Follow(SIM_TRACE_VFO, &Last.Vfo, gCurrentVfo);
+	Follow(SIM_TRACE_AUDIO, &Last.bAudio, ((HOST_BK4819Peek(0x47) >> 8) & 0xFU) != BK4819_AF_MUTE);
+	Follow(SIM_TRACE_SCANNER, &Last.bScanner, gScannerMode);
+	Follow(SIM_TRACE_SCREEN, &Last.ScreenMode, gScreenMode);
+
+	if (HOST_LcdStats.Pixels != Last.Pixels) {
+		Last.Pixels = HOST_LcdStats.Pixels;
+		Last.bDrawing = true;
+	} else if (Last.bDrawing) {
+		Last.bDrawing = false;
+		Follow(SIM_TRACE_FRAME, &Last.Frame, HOST_LcdHash());
+	}
+}
+
+static void Tick(void)
+{
+	HandlerTMR1_BRK_OVF_TRG_HALL();
+	Observe();
+}
+
+static uint32_t HashTrace(void)
+{
+	const uint8_t *pBytes = (const uint8_t *)Trace;
+	uint32_t Hash = 2166136261U;
+	size_t i;
+
+	for (i = 0; i < TraceCount * sizeof(Trace[0]); i++) {
+		Hash = (Hash ^ pBytes[i]) * 16777619U;
+	}
+
+	return Hash;
+}
+
+static void WriteTrace(const char *pPath)
+{
+	FILE *pFile = fopen(pPath, "w");
+	size_t i;
+
+	if (!pFile) {
+		printf("%s: cannot write the trace\n", pPath);
+		HOST_Failures++;
+		return;
+	}
+	fprintf(pFile, "# %s\n", pScenario->pName);
+	for (i = 0; i < TraceCount; i++) {
+		const SIM_Trace_t *pTrace = &Trace[i];
+
+		fprintf(pFile, "%10.3f %-8s ", pTrace->Time / 1e6, TypeNames[pTrace->Type]);
+		if (pTrace->Type == SIM_TRACE_FRAME) {
+			fprintf(pFile, "%08X\n", pTrace->Value);
+		} else {
+			fprintf(pFile, "%u\n", pTrace->Value);
+		}
+	}
+	if (TraceCount == TRACE_COUNT) {
+		fprintf(pFile, "# trace full\n");
+	}
+	fclose(pFile);
+}
+
+static void End(void)
+{
+	SIM_Result_t Result;
+
+	if (pEndHandler) {
+		pEndHandler();
+	}
+	if (pTraceFile) {
+		WriteTrace(pTraceFile);
+	}
+	Result.Failures = HOST_Failures;
+	Result.TraceHash = HashTrace();
+	Result.TraceCount = TraceCount;
+	Result.bCompleted = true;
+	fflush(stdout);
+	HOST_SflashClose();
+	if (write(ResultPipe, &Result, sizeof(Result)) != sizeof(Result)) {
+		_exit(1);
+	}
+	_exit(0);
+}
+
+static SIM_Usage_t ReadUsage(void)
+{
+	SIM_Usage_t Usage;
+
+	Usage.Time = HOST_Time;
+	Usage.Idle = HOST_ClockStats.Idle;
+	Usage.Wakeups = HOST_ClockStats.Wakeups;
+	Usage.Ticks = HOST_ClockStats.Ticks;
+	Usage.BK4819Reads = HOST_BK4819Stats.Reads;
+	Usage.BK4819Writes = HOST_BK4819Stats.Writes;
+	Usage.LcdPixels = HOST_LcdStats.Pixels;
+	Usage.FlashReads = HOST_SflashStats.Reads;
+	Usage.FlashErases = HOST_SflashStats.Erases;
+
+	return Usage;
+}
+
+static void PlayStep(void)
+{
+	const SIM_Step_t *pNow = pStep++;
+
+	if (pNow == pScenario->pSteps) {
+		Start = ReadUsage();
+	}
+	Record(SIM_TRACE_STEP, pNow - pScenario->pSteps);
+	switch (pNow->Type) {
+	case SIM_STEP_KEY:
+		HOST_KeypadSet((KEY_t)pNow->Value);
+		break;
+
+	case SIM_STEP_PTT:
+		HOST_KeypadPtt(pNow->Value);
+		break;
+
+	case SIM_STEP_CARRIER:
+		Carrier.Frequency = pNow->Value;
+		Carrier.Level = pNow->Level;
+		break;
+
+	case SIM_STEP_END:
+		End();
+		break;
+	}
+	HOST_At(SIM_StepTime(pStep - pScenario->pSteps), PlayStep);
+}
+
+static void Boot(void)
+{
+	uint8_t *pImage;
+
+	unlink(IMAGE);
+	HOST_GpioReset();
+	HOST_SerialReset();
+	HOST_ResetClock();
+	HOST_BK4819Reset();
+	HOST_KeypadReset();
+	HOST_LcdReset();
+	HOST_SflashOpen(IMAGE);
+	pImage = HOST_SflashImage();
+	HOST_ImageFormat(pImage);
+	if (pScenario->pSetup) {
+		gSettings_t Settings;
+
+		memcpy(&Settings, pImage + HOST_IMAGE_SETTINGS, sizeof(Settings));
+		pScenario->pSetup(&Settings);
+		memcpy(pImage + HOST_IMAGE_SETTINGS, &Settings, sizeof(Settings));
+	}
+
+	Carrier.Level = HOST_BK4819_NOISE_FLOOR;
+	HOST_BK4819SetSignals(&Carrier, 1);
+	HOST_SetTickHandler(Tick);
+	pStep = pScenario->pSteps;
+	HOST_At(SIM_StepTime(0), PlayStep);
+
+	Main();
+}
+
+SIM_Result_t SIM_Run(const SIM_Scenario_t *pRun, void (*pEnd)(void), const char *pTracePath)
+{
+	SIM_Result_t Result;
+	int Pipe[2];
+	int Status;
+	pid_t Child;
+
+	memset(&Result, 0, sizeof(Result));
+	fflush(stdout);
+	if (pipe(Pipe) != 0) {
+		return Result;
+	}
+	Child = fork();
+	if (Child == 0) {
+		close(Pipe[0]);
+		ResultPipe = Pipe[1];
+		pScenario = pRun;
+		pEndHandler = pEnd;
+		pTraceFile = pTracePath;
+		HOST_Failures = 0;
+		alarm(WATCHDOG_S);
+		Boot();
+	}
+	close(Pipe[1]);
+	if (Child > 0 && read(Pipe[0], &Result, sizeof(Result)) != sizeof(Result)) {
+		memset(&Result, 0, sizeof(Result));
+	}
+	close(Pipe[0]);
+	if (Child > 0 && waitpid(Child, &Status, 0) == Child && WIFSIGNALED(Status)) {
+		printf("%s: signal %d\n", pRun->pName, WTERMSIG(Status));
+	}
+	if (!Result.bCompleted) {
+		printf("%s: the firmware did not reach the end of the script\n", pRun->pName);
+	}
+
+	return Result;
+}
+
+const SIM_Trace_t *SIM_GetTrace(size_t *pCount)
+{
+	*pCount = TraceCount;
+
+	return Trace;
+}
+
+const SIM_Trace_t *SIM_Find(SIM_TraceType_t Type, uint32_t Value, uint64_t Time)
+{
+	size_t i;
+
+	for (i = 0; i < TraceCount; i++) {
+		if (Trace[i].Type == Type && Trace[i].Value == Value && Trace[i].Time >= Time) {
+			return &Trace[i];
+		}
+	}
+
+	return NULL;
+}
+
+size_t SIM_Count(SIM_TraceType_t Type, uint64_t From, uint64_t To)
+{
+	size_t Count = 0;
+	size_t i;
+
+	for (i = 0; i < TraceCount; i++) {
+		if (Trace[i].Type == Type && Trace[i].Time >= From && Trace[i].Time < To) {
+			Count++;
+		}
+	}
+
+	return Count;
+}
+
+uint64_t SIM_StepTime(size_t Index)
+{
+	return (SIM_BOOT_MS + pScenario->pSteps[Index].Time) * 1000000ULL;
+}
+
+SIM_Usage_t SIM_GetUsage(void)
+{
+	SIM_Usage_t Usage = ReadUsage();
+
+	Usage.Time -= Start.Time;
+	Usage.Idle -= Start.Idle;
+	Usage.Wakeups -= Start.Wakeups;
+	Usage.Ticks -= Start.Ticks;
+	Usage.BK4819Reads -= Start.BK4819Reads;
+	Usage.BK4819Writes -= Start.BK4819Writes;
+	Usage.LcdPixels -= Start.LcdPixels;
+	Usage.FlashReads -= Start.FlashReads;
+	Usage.FlashErases -= Start.FlashErases;
+
+	return Usage;
+}
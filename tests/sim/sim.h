@@ -0,0 +1,114 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef TESTS_SIM_SIM_H
+#define TESTS_SIM_SIM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "radio/settings.h"
+
+// Scenario times count from here, the firmware is done booting by then.
+#define SIM_BOOT_MS	3000U
+
+typedef enum {
+	// Holds down Value, a KEY_t, KEY_NONE releases it.
+	SIM_STEP_KEY = 0,
+	// Value is 1 while PTT is held.
+	SIM_STEP_PTT,
+	// Puts the carrier on Value, in 10 Hz, at Level dBm. One carrier at a
+	// time, HOST_BK4819_NOISE_FLOOR takes it off the air.
+	SIM_STEP_CARRIER,
+	// Ends the run, the last step of every script.
+	SIM_STEP_END,
+} SIM_StepType_t;
+
+typedef struct {
+	// ms after SIM_BOOT_MS.
+	uint32_t Time;
+	SIM_StepType_t Type;
+	uint32_t Value;
+	int16_t Level;
+} SIM_Step_t;
+
+typedef struct {
+	const char *pName;
+	// Changes the settings in the image before the firmware boots, may be
+	// NULL.
+	void (*pSetup)(gSettings_t *pSettings);
+	const SIM_Step_t *pSteps;
+} SIM_Scenario_t;
+
+// What the trace records, sampled after every tick and logged on change.
+typedef enum {
+	SIM_TRACE_STEP = 0,
+	SIM_TRACE_RADIO,
+	SIM_TRACE_TUNE,
+	SIM_TRACE_VFO,
+	SIM_TRACE_AUDIO,
+	SIM_TRACE_SCANNER,
+	SIM_TRACE_SCREEN,
+	SIM_TRACE_FRAME,
+} SIM_TraceType_t;
+
+typedef struct {
+	uint64_t Time;
+	SIM_TraceType_t Type;
+	// The new value: gRadioMode, the synthesizer frequency, gCurrentVfo,
+	// 1 for audio on, gScannerMode, gScreenMode or the LCD hash once the
+	// drawing stops, each logged only when it changes. For a step, its
+	// index in the script.
+	uint32_t Value;
+} SIM_Trace_t;
+
+// What the firmware used from the first step of the script on.
+typedef struct {
+	uint64_t Time;
+	uint64_t Idle;
+	uint32_t Wakeups;
+	uint32_t Ticks;
+	uint32_t BK4819Reads;
+	uint32_t BK4819Writes;
+	uint32_t LcdPixels;
+	uint32_t FlashReads;
+	uint32_t FlashErases;
+} SIM_Usage_t;
+
+typedef struct {
+	unsigned int Failures;
+	uint32_t TraceHash;
+	uint32_t TraceCount;
+	bool bCompleted;
+} SIM_Result_t;
+
+// Boots the firmware from a fresh image in a child process and plays the
+// script against it. pEnd runs in the child once the script ends, with the
+// firmware state and the models still there to look at; its CHECK failures
+// come back in the result. With pTracePath set, the trace is also written
+// there as text.
+SIM_Result_t SIM_Run(const SIM_Scenario_t *pScenario, void (*pEnd)(void), const char *pTracePath);
+
+// For pEnd: the trace so far, and the first record of Type with Value at or
+// after Time, or NULL. Times are in ns since reset like HOST_Time.
+const SIM_Trace_t *SIM_GetTrace(size_t *pCount);
+const SIM_Trace_t *SIM_Find(SIM_TraceType_t Type, uint32_t Value, uint64_t Time);
+size_t SIM_Count(SIM_TraceType_t Type, uint64_t From, uint64_t To);
+// When step Index of the script runs.
+uint64_t SIM_StepTime(size_t Index);
+SIM_Usage_t SIM_GetUsage(void);
+
+#endif
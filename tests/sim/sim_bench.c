@@ -0,0 +1,177 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+// Timing profile of the scripted scenarios: how much of the time the core
+// is awake, how busy the buses are, and how long the radio takes to react.
+// Each run also leaves its trace and last screen in build/ to diff and look
+// at, sim_<name>.trace and sim_<name>.ppm.
+
+#include <stdio.h>
+#include "host/check.h"
+#include "host/lcd.h"
+#include "misc.h"
+#include "scenarios.h"
+
+unsigned int HOST_Failures;
+
+static const SIM_Scenario_t *pCurrent;
+
+static double Milliseconds(uint64_t Nanoseconds)
+{
+	return Nanoseconds / 1e6;
+}
+
+// ms from step Index to the first record of Type with Value, -1 if none.
+static double Latency(size_t Index, SIM_TraceType_t Type, uint32_t Value)
+{
+	const SIM_Trace_t *pTrace = SIM_Find(Type, Value, SIM_StepTime(Index));
+
+	return pTrace ? Milliseconds(pTrace->Time - SIM_StepTime(Index)) : -1.0;
+}
+
+// Mean time between the tune records from step Index on, in ms.
+static double TunePeriod(size_t Index)
+{
+	const SIM_Trace_t *pFirst = NULL;
+	const SIM_Trace_t *pLast = NULL;
+	const SIM_Trace_t *pTrace;
+	size_t Count;
+	size_t i;
+
+	pTrace = SIM_GetTrace(&Count);
+	for (i = 0; i < Count; i++) {
+		if (pTrace[i].Type == SIM_TRACE_TUNE && pTrace[i].Time >= SIM_StepTime(Index)) {
+			if (!pFirst) {
+				pFirst = &pTrace[i];
+			}
+			pLast = &pTrace[i];
+		}
+	}
+	if (!pFirst || pFirst == pLast) {
+		return -1.0;
+	}
+
+	return Milliseconds(pLast->Time - pFirst->Time) / (SIM_Count(SIM_TRACE_TUNE, pFirst->Time, pLast->Time + 1) - 1);
+}
+
+static void ReportUsage(void)
+{
+	const SIM_Usage_t Usage = SIM_GetUsage();
+	const double Seconds = Usage.Time / 1e9;
+
+	printf("%-10s %7.1f %7.2f %8.1f %7.1f %8.1f %8.1f %9.0f %6u %6u\n",
+		pCurrent->pName,
+		Seconds,
+		100.0 * (Usage.Time - Usage.Idle) / Usage.Time,
+		Usage.Wakeups / Seconds,
+		Usage.Ticks / Seconds,
+		Usage.BK4819Reads / Seconds,
+		Usage.BK4819Writes / Seconds,
+		Usage.LcdPixels / Seconds,
+		Usage.FlashReads,
+		Usage.FlashErases);
+}
+
+static void ReportScreen(void)
+{
+	char Path[64];
+
+	snprintf(Path, sizeof(Path), "build/sim_%s.ppm", pCurrent->pName);
+	CHECK(HOST_LcdDump(Path));
+}
+
+static void EndKeypad(void)
+{
+	ReportUsage();
+	printf("  key release to retune %6.1f %6.1f %6.1f ms\n",
+		Latency(1, SIM_TRACE_TUNE, SCENARIO_VFO_A + SCENARIO_STEP),
+		Latency(3, SIM_TRACE_TUNE, SCENARIO_VFO_A + (2 * SCENARIO_STEP)),
+		Latency(5, SIM_TRACE_TUNE, SCENARIO_VFO_A + SCENARIO_STEP));
+	ReportScreen();
+}
+
+static void EndCarrier(void)
+{
+	ReportUsage();
+	printf("  receiver open %6.1f ms, closed %6.1f ms\n",
+		Latency(0, SIM_TRACE_RADIO, RADIO_MODE_RX),
+		Latency(1, SIM_TRACE_RADIO, RADIO_MODE_QUIET));
+	ReportScreen();
+}
+
+static void EndSquelch(void)
+{
+	ReportUsage();
+	printf("  squelch open %6.1f ms after -108 dBm, closed %6.1f ms after -125 dBm\n",
+		Latency(2, SIM_TRACE_RADIO, RADIO_MODE_RX),
+		Latency(4, SIM_TRACE_RADIO, RADIO_MODE_QUIET));
+	ReportScreen();
+}
+
+static void EndScanner(void)
+{
+	const SIM_Trace_t *pHit = SIM_Find(SIM_TRACE_TUNE, SCENARIO_SCAN_HIT, SIM_StepTime(1));
+
+	ReportUsage();
+	printf("  scanner on %6.1f ms after the key, %6.1f ms per step, carrier held %6.1f ms after the key\n",
+		Latency(1, SIM_TRACE_SCANNER, 1),
+		TunePeriod(1),
+		pHit ? Latency(1, SIM_TRACE_RADIO, RADIO_MODE_RX) : -1.0);
+	ReportScreen();
+}
+
+static void EndDualWatch(void)
+{
+	ReportUsage();
+	printf("  dual watch %6.1f ms per VFO, receiver open on B %6.1f ms after the carrier\n",
+		TunePeriod(1),
+		Latency(0, SIM_TRACE_RADIO, RADIO_MODE_RX));
+	ReportScreen();
+}
+
+static void EndSaveMode(void)
+{
+	ReportUsage();
+	printf("  key release to retune %6.1f ms, receiver open %6.1f ms\n",
+		Latency(1, SIM_TRACE_TUNE, SCENARIO_VFO_A + SCENARIO_STEP),
+		Latency(2, SIM_TRACE_RADIO, RADIO_MODE_RX));
+	ReportScreen();
+}
+
+static void Bench(const SIM_Scenario_t *pScenario, void (*pEnd)(void))
+{
+	char Path[64];
+	SIM_Result_t Result;
+
+	pCurrent = pScenario;
+	snprintf(Path, sizeof(Path), "build/sim_%s.trace", pScenario->pName);
+	Result = SIM_Run(pScenario, pEnd, Path);
+	CHECK(Result.bCompleted);
+	HOST_Failures += Result.Failures;
+}
+
+int main(void)
+{
+	printf("scenario   seconds awake %%  wakeup/s  tick/s  4819 r/s 4819 w/s  pixels/s sfread sferase\n");
+	Bench(&SCENARIO_Keypad, EndKeypad);
+	Bench(&SCENARIO_Carrier, EndCarrier);
+	Bench(&SCENARIO_Squelch, EndSquelch);
+	Bench(&SCENARIO_Scanner, EndScanner);
+	Bench(&SCENARIO_DualWatch, EndDualWatch);
+	Bench(&SCENARIO_SaveMode, EndSaveMode);
+
+	return HOST_Failures ? 1 : 0;
+}
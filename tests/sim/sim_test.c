@@ -0,0 +1,206 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+// Scripted runs of the whole firmware, checked against what the radio
+// should do. Each check runs in the child at the end of its scenario.
+
+#include "app/radio.h"
+#include "host/bk4819.h"
+#include "host/check.h"
+#include "host/clock.h"
+#include "misc.h"
+#include "scenarios.h"
+
+#define MS	1000000ULL
+
+unsigned int HOST_Failures;
+
+extern volatile uint32_t gTimeSinceBoot;
+
+// Time from step Index of the script to the first record of Type with
+// Value, or UINT64_MAX if there is none.
+static uint64_t Latency(size_t Index, SIM_TraceType_t Type, uint32_t Value)
+{
+	const SIM_Trace_t *pTrace = SIM_Find(Type, Value, SIM_StepTime(Index));
+
+	return pTrace ? pTrace->Time - SIM_StepTime(Index) : UINT64_MAX;
+}
+
+static void Run(const SIM_Scenario_t *pScenario, void (*pCheck)(void))
+{
+	const SIM_Result_t Result = SIM_Run(pScenario, pCheck, NULL);
+
+	CHECK(Result.bCompleted);
+	HOST_Failures += Result.Failures;
+}
+
+// A short press acts on the release, within a tick or two of the scan.
+static void CheckKeypad(void)
+{
+	CHECK(Latency(1, SIM_TRACE_TUNE, SCENARIO_VFO_A + SCENARIO_STEP) < 150 * MS);
+	CHECK(Latency(3, SIM_TRACE_TUNE, SCENARIO_VFO_A + (2 * SCENARIO_STEP)) < 150 * MS);
+	CHECK(Latency(5, SIM_TRACE_TUNE, SCENARIO_VFO_A + SCENARIO_STEP) < 150 * MS);
+	CHECK(SIM_Count(SIM_TRACE_FRAME, SIM_StepTime(1), SIM_StepTime(2)) > 0);
+	CHECK_EQUAL(SIM_Count(SIM_TRACE_TUNE, SIM_StepTime(0), SIM_StepTime(1)), 0);
+	CHECK_EQUAL(gSettings.CurrentVfo, 0);
+}
+
+static void TestKeypad(void)
+{
+	Run(&SCENARIO_Keypad, CheckKeypad);
+}
+
+static void CheckCarrier(void)
+{
+	CHECK(Latency(0, SIM_TRACE_RADIO, RADIO_MODE_RX) < 20 * MS);
+	CHECK(Latency(0, SIM_TRACE_AUDIO, 1) < 20 * MS);
+	CHECK(Latency(1, SIM_TRACE_RADIO, RADIO_MODE_QUIET) < 20 * MS);
+	CHECK(Latency(1, SIM_TRACE_AUDIO, 0) < 20 * MS);
+	CHECK_EQUAL(gRadioMode, RADIO_MODE_QUIET);
+}
+
+static void TestCarrier(void)
+{
+	Run(&SCENARIO_Carrier, CheckCarrier);
+}
+
+// Opens only above the upper threshold, stays open in between.
+static void CheckSquelch(void)
+{
+	CHECK_EQUAL(SIM_Count(SIM_TRACE_RADIO, SIM_StepTime(0), SIM_StepTime(2)), 0);
+	CHECK(Latency(2, SIM_TRACE_RADIO, RADIO_MODE_RX) < 20 * MS);
+	CHECK_EQUAL(SIM_Count(SIM_TRACE_RADIO, SIM_StepTime(2) + (20 * MS), SIM_StepTime(4)), 0);
+	CHECK(Latency(4, SIM_TRACE_RADIO, RADIO_MODE_QUIET) < 20 * MS);
+}
+
+static void TestSquelch(void)
+{
+	Run(&SCENARIO_Squelch, CheckSquelch);
+}
+
+// A long press starts the scanner after a second, which then steps up until
+// the carrier holds it.
+static void CheckScanner(void)
+{
+	const SIM_Trace_t *pHit = SIM_Find(SIM_TRACE_TUNE, SCENARIO_SCAN_HIT, SIM_StepTime(1));
+	const uint64_t Start = Latency(1, SIM_TRACE_SCANNER, 1);
+
+	CHECK(Start >= 1000 * MS && Start < 1100 * MS);
+	CHECK(pHit != NULL);
+	if (pHit) {
+		CHECK(SIM_Find(SIM_TRACE_RADIO, RADIO_MODE_RX, pHit->Time) != NULL);
+		CHECK_EQUAL(SIM_Count(SIM_TRACE_TUNE, pHit->Time + 1, HOST_Time), 0);
+	}
+	CHECK_EQUAL(SIM_Count(SIM_TRACE_TUNE, SIM_StepTime(1), HOST_Time), 4);
+	CHECK_EQUAL(gRadioMode, RADIO_MODE_RX);
+	CHECK_EQUAL(HOST_BK4819Frequency(), SCENARIO_SCAN_HIT);
+}
+
+static void TestScanner(void)
+{
+	Run(&SCENARIO_Scanner, CheckScanner);
+}
+
+// Dual watch flips between the VFOs every 150 ms until a carrier holds it.
+static void CheckDualWatch(void)
+{
+	const SIM_Trace_t *pB = SIM_Find(SIM_TRACE_TUNE, SCENARIO_VFO_B, SIM_StepTime(0) - (1000 * MS));
+	const SIM_Trace_t *pA = pB ? SIM_Find(SIM_TRACE_TUNE, SCENARIO_VFO_A, pB->Time) : NULL;
+
+	CHECK(pA != NULL);
+	if (pA) {
+		CHECK_EQUAL(pA->Time - pB->Time, 150 * MS);
+	}
+	CHECK(Latency(0, SIM_TRACE_RADIO, RADIO_MODE_RX) < 170 * MS);
+	CHECK_EQUAL(SIM_Count(SIM_TRACE_TUNE, SIM_StepTime(0) + (170 * MS), SIM_StepTime(1)), 0);
+	CHECK(Latency(1, SIM_TRACE_RADIO, RADIO_MODE_QUIET) < 20 * MS);
+	CHECK(SIM_Count(SIM_TRACE_TUNE, SIM_StepTime(1), SIM_StepTime(2)) >= 5);
+}
+
+static void TestDualWatch(void)
+{
+	Run(&SCENARIO_DualWatch, CheckDualWatch);
+}
+
+// Battery save stretches the tick to 16 ms while idle without losing time,
+// and still answers a key and a carrier.
+static void CheckSaveMode(void)
+{
+	const uint32_t Elapsed = HOST_Time / MS;
+
+	CHECK(HOST_ClockStats.Ticks < gTimeSinceBoot - 1000);
+	CHECK(gTimeSinceBoot <= Elapsed && gTimeSinceBoot + 300 > Elapsed);
+	CHECK(Latency(1, SIM_TRACE_TUNE, SCENARIO_VFO_A + SCENARIO_STEP) < 150 * MS);
+	CHECK(Latency(2, SIM_TRACE_RADIO, RADIO_MODE_RX) < 200 * MS);
+	CHECK(Latency(3, SIM_TRACE_RADIO, RADIO_MODE_QUIET) < 20 * MS);
+}
+
+static void TestSaveMode(void)
+{
+	Run(&SCENARIO_SaveMode, CheckSaveMode);
+}
+
+// PTT during the roger beep cuts it short and transmits again, so the radio
+// only goes quiet after the beep of the second release.
+static void CheckRoger(void)
+{
+	CHECK(Latency(0, SIM_TRACE_RADIO, RADIO_MODE_TX) < 150 * MS);
+	CHECK(Latency(3, SIM_TRACE_RADIO, RADIO_MODE_QUIET) >= 180 * MS);
+	CHECK(Latency(3, SIM_TRACE_RADIO, RADIO_MODE_QUIET) < 250 * MS);
+	CHECK_EQUAL(gRadioMode, RADIO_MODE_QUIET);
+}
+
+static void TestRoger(void)
+{
+	Run(&SCENARIO_Roger, CheckRoger);
+}
+
+// TIMER_DISPLAY checks the timeout once a second, through the 16 ms battery
+// save ticks too.
+static void CheckDisplayTimer(void)
+{
+	CHECK(gEnableBlink);
+}
+
+static void TestDisplayTimer(void)
+{
+	Run(&SCENARIO_DisplayTimer, CheckDisplayTimer);
+}
+
+static void TestReproducible(void)
+{
+	const SIM_Result_t First = SIM_Run(&SCENARIO_Scanner, NULL, NULL);
+	const SIM_Result_t Second = SIM_Run(&SCENARIO_Scanner, NULL, NULL);
+
+	CHECK(First.bCompleted && Second.bCompleted);
+	CHECK_EQUAL(First.TraceCount, Second.TraceCount);
+	CHECK_EQUAL(First.TraceHash, Second.TraceHash);
+}
+
+int main(void)
+{
+	RUN(TestKeypad);
+	RUN(TestCarrier);
+	RUN(TestSquelch);
+	RUN(TestScanner);
+	RUN(TestDualWatch);
+	RUN(TestSaveMode);
+	RUN(TestRoger);
+	RUN(TestDisplayTimer);
+	RUN(TestReproducible);
+
+	return HOST_Failures ? 1 : 0;
+}
@@ -0,0 +1,178 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+// Links app/uart.c and driver/serial-flash.c with the host drivers and stands
+// in for the scheduler, settings and hardware calls they make.
+
+#include <string.h>
+#include <unistd.h>
+#include "app/uart.h"
+#include "driver/uart.h"
+#include "fixture.h"
+#include "host/clock.h"
+#include "host/gpio.h"
+#include "host/serial.h"
+#include "host/sflash.h"
+#include "radio/hardware.h"
+#include "radio/scheduler.h"
+#include "radio/settings.h"
+
+FIXTURE_Calls_t gFixtureCalls;
+
+volatile uint32_t gTimeSinceBoot;
+
+static uint32_t TimerDeadline[TIMER_COUNT];
+static uint32_t TimerMask;
+
+// The part of SCHEDULER_Tick() app/uart.c relies on.
+static void Tick(void)
+{
+	uint8_t i;
+
+	gTimeSinceBoot++;
+	for (i = 0; i < TIMER_COUNT; i++) {
+		if ((TimerMask & (1U << i)) && (int32_t)(TimerDeadline[i] - gTimeSinceBoot) <= 0) {
+			TimerMask &= ~(1U << i);
+			if (i == TIMER_UART) {
+				UART_IsRunning = false;
+			}
+		}
+	}
+}
+
+void SCHEDULER_StartTimer(uint8_t Timer, uint32_t Delay)
+{
+	TimerDeadline[Timer] = gTimeSinceBoot + Delay;
+	TimerMask |= 1U << Timer;
+}
+
+void SCHEDULER_StopTimer(uint8_t Timer)
+{
+	TimerMask &= ~(1U << Timer);
+}
+
+bool SCHEDULER_IsTimerRunning(uint8_t Timer)
+{
+	return (TimerMask & (1U << Timer)) && (int32_t)(TimerDeadline[Timer] - gTimeSinceBoot) > 0;
+}
+
+void SCHEDULER_WakeUp(void)
+{
+}
+
+void HARDWARE_Reboot(void)
+{
+	gFixtureCalls.Reboots++;
+}
+
+void HARDWARE_EnableInterrupts(bool bEnable)
+{
+	if (bEnable) {
+		__enable_irq();
+	} else {
+		__disable_irq();
+	}
+}
+
+void SETTINGS_BackupCalibration(void)
+{
+	gFixtureCalls.CalibrationBackups++;
+}
+
+void SETTINGS_BackupSettings(void)
+{
+	gFixtureCalls.SettingsBackups++;
+}
+
+void FIXTURE_Setup(const char *pImage, uint32_t Baud)
+{
+	uint8_t Discard[256];
+
+	unlink(pImage);
+	HOST_GpioReset();
+	HOST_SerialReset();
+	HOST_ResetClock();
+	memset(&gFixtureCalls, 0, sizeof(gFixtureCalls));
+	TimerMask = 0;
+	UART_IsRunning = false;
+
+	HOST_TMR1.pr = 999;
+	HOST_TMR1.ctrl1_bit.tmren = TRUE;
+	HOST_SetTickHandler(Tick);
+	HOST_SflashOpen(pImage);
+	UART_Init(Baud);
+
+	FIXTURE_Wait(200);
+	while (FIXTURE_Reply(Discard, sizeof(Discard))) {
+	}
+}
+
+void FIXTURE_Teardown(void)
+{
+	HOST_SflashClose();
+}
+
+uint8_t FIXTURE_Sum(const uint8_t *pBytes, size_t Size)
+{
+	uint8_t Sum = 0;
+	size_t i;
+
+	for (i = 0; i < Size; i++) {
+		Sum += pBytes[i];
+	}
+
+	return Sum;
+}
+
+void FIXTURE_BuildWrite(uint8_t *pFrame, uint8_t Command, uint16_t Block, const uint8_t *pData)
+{
+	pFrame[0] = Command;
+	pFrame[1] = Block >> 8;
+	pFrame[2] = Block & 0xFF;
+	memcpy(pFrame + 3, pData, 128);
+	pFrame[131] = FIXTURE_Sum(pFrame, 131);
+}
+
+void FIXTURE_BuildCommand(uint8_t *pFrame, uint8_t Command, uint8_t Value)
+{
+	pFrame[0] = Command;
+	pFrame[1] = 0;
+	pFrame[2] = 0;
+	pFrame[3] = Value;
+	pFrame[4] = FIXTURE_Sum(pFrame, 4);
+	// The handshake adds one to its sum.
+	if (Command == 0x32) {
+		pFrame[4]++;
+	}
+}
+
+void FIXTURE_BuildRead(uint8_t *pFrame, uint16_t Block)
+{
+	pFrame[0] = 0x52;
+	pFrame[1] = Block >> 8;
+	pFrame[2] = Block & 0xFF;
+	pFrame[3] = FIXTURE_Sum(pFrame, 3);
+}
+
+size_t FIXTURE_Reply(uint8_t *pReply, size_t Size)
+{
+	return HOST_SerialTake(pReply, Size);
+}
+
+void FIXTURE_Wait(uint32_t Milliseconds)
+{
+	HOST_RunUntil(HOST_Time + Milliseconds * 1000000ULL);
+}
@@ -0,0 +1,47 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef TESTS_UART_FIXTURE_H
+#define TESTS_UART_FIXTURE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+	uint32_t Reboots;
+	uint32_t CalibrationBackups;
+	uint32_t SettingsBackups;
+} FIXTURE_Calls_t;
+
+extern FIXTURE_Calls_t gFixtureCalls;
+
+// Fresh flash image at pImage, clock at zero, TMR1 running and the UART at
+// Baud. The frame parser keeps its state across fixtures, so each one also
+// idles past the frame timeout before returning.
+void FIXTURE_Setup(const char *pImage, uint32_t Baud);
+void FIXTURE_Teardown(void);
+uint8_t FIXTURE_Sum(const uint8_t *pBytes, size_t Size);
+// Builds the 132-byte frame of a 0x40-0x4C write.
+void FIXTURE_BuildWrite(uint8_t *pFrame, uint8_t Command, uint16_t Block, const uint8_t *pData);
+// 5-byte 0x32 and 0x35 frames, Value in byte 3.
+void FIXTURE_BuildCommand(uint8_t *pFrame, uint8_t Command, uint8_t Value);
+void FIXTURE_BuildRead(uint8_t *pFrame, uint16_t Block);
+// Collects what the firmware sent, returns how many bytes there were.
+size_t FIXTURE_Reply(uint8_t *pReply, size_t Size);
+void FIXTURE_Wait(uint32_t Milliseconds);
+
+#endif
@@ -0,0 +1,144 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+// Programming throughput in virtual time: what a flashing tool that waits for
+// each answer gets out of the link at each line rate, erases included.
+
+#include <stdio.h>
+#include <string.h>
+#include "fixture.h"
+#include "host/check.h"
+#include "host/clock.h"
+#include "host/serial.h"
+#include "host/sflash.h"
+
+#define IMAGE "build/uart_bench.img"
+
+// The calibration region, then the first 64 blocks of the 40-sector 0x41
+// region whose block 0 erases all of it.
+#define CALIBRATION_BLOCKS	32U
+#define REGION_BLOCKS		64U
+#define READ_BLOCKS		64U
+
+unsigned int HOST_Failures;
+
+static const uint32_t Bauds[] = {
+	9600,
+	19200,
+	38400,
+	57600,
+	115200,
+	230400,
+	460800,
+};
+
+static uint8_t Data[128];
+
+// Returns how many blocks were not answered with 0x06.
+static uint32_t Program(uint8_t Command, uint16_t Blocks)
+{
+	uint8_t Frame[132];
+	uint8_t Reply[4];
+	uint32_t Failures = 0;
+	uint16_t i;
+
+	for (i = 0; i < Blocks; i++) {
+		memset(Data, (uint8_t)i, sizeof(Data));
+		FIXTURE_BuildWrite(Frame, Command, i, Data);
+		HOST_SerialReceive(Frame, sizeof(Frame));
+		if (FIXTURE_Reply(Reply, sizeof(Reply)) != 1 || Reply[0] != 0x06) {
+			Failures++;
+		}
+	}
+
+	return Failures;
+}
+
+static uint32_t Read(uint16_t Blocks)
+{
+	uint8_t Frame[4];
+	uint8_t Reply[140];
+	uint32_t Failures = 0;
+	uint16_t i;
+
+	for (i = 0; i < Blocks; i++) {
+		FIXTURE_BuildRead(Frame, i);
+		HOST_SerialReceive(Frame, sizeof(Frame));
+		if (FIXTURE_Reply(Reply, sizeof(Reply)) != 132) {
+			Failures++;
+		}
+	}
+
+	return Failures;
+}
+
+static double Rate(uint32_t Bytes, uint64_t Nanoseconds)
+{
+	return Nanoseconds ? (Bytes * 1e9) / Nanoseconds : 0.0;
+}
+
+static void Bench(uint32_t Baud)
+{
+	const double Line = Baud / 10.0;
+	uint8_t Frame[5];
+	uint8_t Reply[4];
+	uint64_t Start;
+	uint64_t WriteTime;
+	uint64_t ReadTime;
+	uint32_t Failures;
+
+	FIXTURE_Setup(IMAGE, Baud);
+
+	FIXTURE_BuildCommand(Frame, 0x32, 0x10);
+	HOST_SerialReceive(Frame, sizeof(Frame));
+	CHECK_EQUAL(FIXTURE_Reply(Reply, sizeof(Reply)), 1);
+
+	Start = HOST_Time;
+	Failures = Program(0x48, CALIBRATION_BLOCKS);
+	Failures += Program(0x41, REGION_BLOCKS);
+	WriteTime = HOST_Time - Start;
+
+	Start = HOST_Time;
+	Failures += Read(READ_BLOCKS);
+	ReadTime = HOST_Time - Start;
+
+	CHECK_EQUAL(Failures, 0);
+	CHECK_EQUAL(HOST_SerialStats.Overruns, 0);
+	CHECK_EQUAL(HOST_SflashStats.Errors, 0);
+
+	printf("%7u %9.0f %9.0f %5.1f%% %9.0f %5.1f%% %7u\n",
+		Baud,
+		Line,
+		Rate((CALIBRATION_BLOCKS + REGION_BLOCKS) * 128U, WriteTime),
+		100.0 * Rate((CALIBRATION_BLOCKS + REGION_BLOCKS) * 128U, WriteTime) / Line,
+		Rate(READ_BLOCKS * 128U, ReadTime),
+		100.0 * Rate(READ_BLOCKS * 128U, ReadTime) / Line,
+		HOST_SflashStats.Erases);
+
+	FIXTURE_Teardown();
+}
+
+int main(void)
+{
+	uint8_t i;
+
+	printf("   baud    line/s   write/s  line    read/s  line  erases\n");
+	for (i = 0; i < sizeof(Bauds) / sizeof(Bauds[0]); i++) {
+		Bench(Bauds[i]);
+	}
+
+	return HOST_Failures ? 1 : 0;
+}
@@ -0,0 +1,358 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <string.h>
+#include "app/uart.h"
+#include "driver/pins.h"
+#include "fixture.h"
+#include "host/check.h"
+#include "host/clock.h"
+#include "host/gpio.h"
+#include "host/serial.h"
+#include "host/sflash.h"
+
+#define IMAGE "build/uart_test.img"
+
+unsigned int HOST_Failures;
+
+static uint8_t Data[128];
+
+static void FillData(uint8_t Seed)
+{
+	uint8_t i;
+
+	for (i = 0; i < sizeof(Data); i++) {
+		Data[i] = (uint8_t)(Seed + (i * 7));
+	}
+}
+
+static uint8_t ReplyByte(void)
+{
+	uint8_t Reply[4];
+
+	if (FIXTURE_Reply(Reply, sizeof(Reply)) != 1) {
+		return 0x00;
+	}
+
+	return Reply[0];
+}
+
+static void SendCommand(uint8_t Command, uint8_t Value)
+{
+	uint8_t Frame[5];
+
+	FIXTURE_BuildCommand(Frame, Command, Value);
+	HOST_SerialReceive(Frame, sizeof(Frame));
+}
+
+static void SendWrite(uint8_t Command, uint16_t Block)
+{
+	uint8_t Frame[132];
+
+	FIXTURE_BuildWrite(Frame, Command, Block, Data);
+	HOST_SerialReceive(Frame, sizeof(Frame));
+}
+
+static void TestHandshake(void)
+{
+	uint8_t Frame[5];
+
+	FIXTURE_Setup(IMAGE, 115200);
+
+	SendCommand(0x32, 0x10);
+	CHECK_EQUAL(ReplyByte(), 0x06);
+	CHECK(UART_IsRunning);
+
+	// Any other value opens the session without an answer.
+	SendCommand(0x32, 0x16);
+	CHECK_EQUAL(HOST_SerialStats.Sent, 1);
+	CHECK(UART_IsRunning);
+
+	FIXTURE_BuildCommand(Frame, 0x32, 0x10);
+	Frame[4]--;
+	HOST_SerialReceive(Frame, sizeof(Frame));
+	CHECK_EQUAL(ReplyByte(), 0xFF);
+	CHECK(!UART_IsRunning);
+
+	FIXTURE_Teardown();
+}
+
+static void TestSessionCommand(void)
+{
+	uint8_t Frame[5];
+
+	FIXTURE_Setup(IMAGE, 115200);
+
+	SendCommand(0x35, 0x10);
+	CHECK_EQUAL(ReplyByte(), 0x06);
+	CHECK(UART_IsRunning);
+
+	FIXTURE_BuildCommand(Frame, 0x35, 0x10);
+	Frame[4] ^= 0x80;
+	HOST_SerialReceive(Frame, sizeof(Frame));
+	CHECK_EQUAL(ReplyByte(), 0xFF);
+
+	// Closing a session that wrote nothing does not reboot.
+	SendCommand(0x35, 0xEE);
+	CHECK_EQUAL(HOST_SerialStats.Sent, 2);
+	CHECK(!UART_IsRunning);
+	CHECK_EQUAL(gFixtureCalls.Reboots, 0);
+
+	FIXTURE_Teardown();
+}
+
+static void TestUnknownCommand(void)
+{
+	const uint8_t Byte = 0x99;
+
+	FIXTURE_Setup(IMAGE, 115200);
+
+	SendCommand(0x32, 0x10);
+	CHECK_EQUAL(ReplyByte(), 0x06);
+	HOST_SerialReceive(&Byte, 1);
+	CHECK_EQUAL(ReplyByte(), 0xFF);
+	CHECK(!UART_IsRunning);
+
+	FIXTURE_Teardown();
+}
+
+static void TestWriteRegions(void)
+{
+	static const struct {
+		uint8_t Command;
+		uint16_t Page;
+		uint16_t Count;
+	} Regions[] = {
+		{ 0x40, 0x000, 0x2D0 },
+		{ 0x41, 0x2D0, 0x028 },
+		{ 0x42, 0x2F8, 0x022 },
+		{ 0x43, 0x31A, 0x002 },
+		{ 0x47, 0x3B5, 0x00A },
+		{ 0x4B, 0x3D8, 0x00A },
+		{ 0x4C, 0x31C, 0x099 },
+	};
+	uint8_t i;
+
+	for (i = 0; i < sizeof(Regions) / sizeof(Regions[0]); i++) {
+		const uint32_t Start = Regions[i].Page * 4096U;
+		const uint32_t End = Start + (Regions[i].Count * 4096U);
+		uint8_t *pImage;
+
+		FIXTURE_Setup(IMAGE, 115200);
+		// Block 0 of 0x40 erases 720 sectors; polling through each at
+		// the typical erase time costs seconds of host time.
+		HOST_SflashEraseTime = 50000U;
+		pImage = HOST_SflashImage();
+		memset(pImage + Start, 0x00, End - Start);
+
+		FillData(Regions[i].Command);
+		SendWrite(Regions[i].Command, 0);
+		CHECK_EQUAL(ReplyByte(), 0x06);
+		CHECK(memcmp(pImage + Start, Data, sizeof(Data)) == 0);
+		// Block 0 erases the whole region first.
+		CHECK_EQUAL(pImage[Start + 128], 0xFF);
+		CHECK_EQUAL(pImage[End - 1], 0xFF);
+		CHECK_EQUAL(HOST_SflashStats.Erases, Regions[i].Count);
+
+		FillData(Regions[i].Command + 1);
+		SendWrite(Regions[i].Command, 5);
+		CHECK_EQUAL(ReplyByte(), 0x06);
+		CHECK(memcmp(pImage + Start + (5 * 128), Data, sizeof(Data)) == 0);
+		CHECK_EQUAL(HOST_SflashStats.Erases, Regions[i].Count);
+		CHECK_EQUAL(HOST_SflashStats.Errors, 0);
+
+		FIXTURE_Teardown();
+	}
+}
+
+static void TestWriteReboots(void)
+{
+	FIXTURE_Setup(IMAGE, 115200);
+
+	FillData(0x48);
+	SendWrite(0x48, 0);
+	CHECK_EQUAL(ReplyByte(), 0x06);
+	CHECK(memcmp(HOST_SflashImage() + (0x3BF * 4096U), Data, sizeof(Data)) == 0);
+	SendCommand(0x35, 0xEE);
+	CHECK_EQUAL(gFixtureCalls.CalibrationBackups, 1);
+	CHECK_EQUAL(gFixtureCalls.SettingsBackups, 0);
+	CHECK_EQUAL(gFixtureCalls.Reboots, 1);
+	CHECK(HOST_GpioOutput(GPIOA, BOARD_GPIOA_LED_GREEN));
+
+	FillData(0x49);
+	SendWrite(0x49, 0);
+	CHECK_EQUAL(ReplyByte(), 0x06);
+	SendCommand(0x35, 0xEE);
+	CHECK_EQUAL(gFixtureCalls.CalibrationBackups, 1);
+	CHECK_EQUAL(gFixtureCalls.SettingsBackups, 1);
+	CHECK_EQUAL(gFixtureCalls.Reboots, 2);
+
+	FIXTURE_Teardown();
+}
+
+static void TestRead(void)
+{
+	uint8_t Frame[4];
+	uint8_t Reply[140];
+	uint8_t *pImage;
+	uint16_t i;
+
+	FIXTURE_Setup(IMAGE, 115200);
+	pImage = HOST_SflashImage();
+	for (i = 0; i < 128; i++) {
+		pImage[(0x0123 * 128) + i] = (uint8_t)(i ^ 0x5A);
+	}
+
+	FIXTURE_BuildRead(Frame, 0x0123);
+	HOST_SerialReceive(Frame, sizeof(Frame));
+	CHECK_EQUAL(FIXTURE_Reply(Reply, sizeof(Reply)), 132);
+	CHECK_EQUAL(Reply[0], 0x52);
+	CHECK_EQUAL(Reply[1], 0x01);
+	CHECK_EQUAL(Reply[2], 0x23);
+	CHECK(memcmp(Reply + 3, pImage + (0x0123 * 128), 128) == 0);
+	CHECK_EQUAL(Reply[131], FIXTURE_Sum(Reply, 131));
+	// Unlike writes, reads leave the tick running.
+	CHECK(HOST_TMR1.ctrl1_bit.tmren);
+
+	Frame[3]++;
+	HOST_SerialReceive(Frame, sizeof(Frame));
+	CHECK_EQUAL(FIXTURE_Reply(Reply, sizeof(Reply)), 1);
+	CHECK_EQUAL(Reply[0], 0xFF);
+
+	FIXTURE_Teardown();
+}
+
+static void TestBadWriteChecksum(void)
+{
+	uint8_t Frame[132];
+
+	FIXTURE_Setup(IMAGE, 115200);
+
+	FillData(0x11);
+	FIXTURE_BuildWrite(Frame, 0x43, 0, Data);
+	Frame[131] ^= 0x01;
+	HOST_SerialReceive(Frame, sizeof(Frame));
+	CHECK_EQUAL(ReplyByte(), 0xFF);
+	CHECK_EQUAL(HOST_SflashStats.Erases, 0);
+	CHECK_EQUAL(HOST_SflashStats.Programs, 0);
+	CHECK(!HOST_GpioOutput(GPIOA, BOARD_GPIOA_LED_RED));
+
+	// The parser is back at a frame boundary.
+	Frame[131] ^= 0x01;
+	HOST_SerialReceive(Frame, sizeof(Frame));
+	CHECK_EQUAL(ReplyByte(), 0x06);
+
+	FIXTURE_Teardown();
+}
+
+static void TestSplitFrame(void)
+{
+	uint8_t Frame[132];
+	uint8_t i;
+
+	FIXTURE_Setup(IMAGE, 115200);
+
+	FillData(0x22);
+	FIXTURE_BuildWrite(Frame, 0x43, 1, Data);
+	// Chunks as a USB serial adapter hands them over, with gaps well under
+	// the 100 ms frame timeout.
+	for (i = 0; i < 128; i += 32) {
+		HOST_SerialReceive(Frame + i, 32);
+		FIXTURE_Wait(40);
+	}
+	CHECK_EQUAL(HOST_SerialStats.Sent, 0);
+	HOST_SerialReceive(Frame + 128, 4);
+	CHECK_EQUAL(ReplyByte(), 0x06);
+	CHECK(memcmp(HOST_SflashImage() + (0x31A * 4096U) + 128, Data, sizeof(Data)) == 0);
+
+	FIXTURE_Teardown();
+}
+
+static void TestFrameTimeout(void)
+{
+	uint8_t Frame[5];
+
+	FIXTURE_Setup(IMAGE, 115200);
+
+	// Half a frame, then the host goes quiet past the timeout.
+	FIXTURE_BuildCommand(Frame, 0x32, 0x10);
+	HOST_SerialReceive(Frame, 3);
+	FIXTURE_Wait(150);
+	CHECK_EQUAL(HOST_SerialStats.Sent, 0);
+
+	// The stale bytes are dropped instead of completing this frame.
+	HOST_SerialReceive(Frame, sizeof(Frame));
+	CHECK_EQUAL(ReplyByte(), 0x06);
+
+	// Under the timeout the halves still join up.
+	HOST_SerialReceive(Frame, 3);
+	FIXTURE_Wait(90);
+	HOST_SerialReceive(Frame + 3, 2);
+	CHECK_EQUAL(ReplyByte(), 0x06);
+
+	FIXTURE_Teardown();
+}
+
+static void TestSessionTimeout(void)
+{
+	FIXTURE_Setup(IMAGE, 115200);
+
+	SendCommand(0x32, 0x10);
+	CHECK_EQUAL(ReplyByte(), 0x06);
+	FIXTURE_Wait(900);
+	CHECK(UART_IsRunning);
+	SendCommand(0x35, 0x10);
+	CHECK_EQUAL(ReplyByte(), 0x06);
+	FIXTURE_Wait(900);
+	CHECK(UART_IsRunning);
+	FIXTURE_Wait(200);
+	CHECK(!UART_IsRunning);
+
+	FIXTURE_Teardown();
+}
+
+// Writes stop TMR1 and leave it off, so no timeout can end a flashing
+// session; only the 0xEE command and its reboot do.
+static void TestWriteStopsTimers(void)
+{
+	FIXTURE_Setup(IMAGE, 115200);
+
+	FillData(0x33);
+	SendWrite(0x43, 0);
+	CHECK_EQUAL(ReplyByte(), 0x06);
+	CHECK(!HOST_TMR1.ctrl1_bit.tmren);
+	FIXTURE_Wait(5000);
+	CHECK(UART_IsRunning);
+
+	FIXTURE_Teardown();
+}
+
+int main(void)
+{
+	RUN(TestHandshake);
+	RUN(TestSessionCommand);
+	RUN(TestUnknownCommand);
+	RUN(TestWriteRegions);
+	RUN(TestWriteReboots);
+	RUN(TestRead);
+	RUN(TestBadWriteChecksum);
+	RUN(TestSplitFrame);
+	RUN(TestFrameTimeout);
+	RUN(TestSessionTimeout);
+	RUN(TestWriteStopsTimers);
+
+	return HOST_Failures ? 1 : 0;
+}
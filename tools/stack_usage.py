@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+# Copyright 2023 Dual Tachyon
+# https://github.com/DualTachyon
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Worst case stack depth per entry point from the .ci files written by
+# gcc -fcallgraph-info=su. Indirect calls are resolved to the functions of
+# the caller's file that are never called directly (dispatch tables) plus
+# whatever INDIRECT_TARGETS lists for the calling function or file.
+
+import glob
+import re
+import sys
+
+ENTRY_POINTS = [
+	'Main',
+	'HandlerTMR1_BRK_OVF_TRG_HALL',
+	'HandlerTMR6_GLOBAL',
+	'HandlerUSART1',
+]
+INDIRECT_TARGETS = {
+	'main.c': r'^(Task_\w+|SCHEDULER_RunDeferred)$',
+	'radio/scheduler.c': r'^(UartTimeout|RaiseDeferred|NextRogerStep)$',
+	'task/keyaction.c': r'^ACTION_\w+_fn$',
+}
+
+NODE = re.compile(r'node: \{ title: "([^"]+)" label: "[^\\]*\\n([^:\\]+):[^"]*?(?:\\n(\d+) bytes \((\w+)\))?[\\"]')
+EDGE = re.compile(r'edge: \{ sourcename: "([^"]+)" targetname: "([^"]+)"')
+
+frames = {}
+files = {}
+calls = {}
+
+for name in glob.glob('**/*.ci', recursive=True):
+	with open(name) as f:
+		text = f.read()
+	for title, source, size, kind in NODE.findall(text):
+		if size:
+			frames[title] = (int(size), kind)
+			files[title] = source
+	for caller, callee in EDGE.findall(text):
+		calls.setdefault(caller, set()).add(callee)
+
+if not frames:
+	sys.exit('No .ci files found, build with "make stack" first')
+
+# Static functions are titled "file.c:name", direct calls from other files use the plain name.
+plain = {title.split(':')[-1]: title for title in frames}
+called = set()
+for callees in calls.values():
+	called |= {plain.get(c, c) for c in callees}
+
+def indirect_targets(caller):
+	source = files.get(caller)
+	pattern = INDIRECT_TARGETS.get(caller) or INDIRECT_TARGETS.get(source)
+	for title in frames:
+		name = title.split(':')[-1]
+		if pattern and re.match(pattern, name):
+			yield title
+		elif files[title] == source and title not in called and title != caller:
+			yield title
+
+notes = set()
+depth = {}
+
+def worst(title, path):
+	title = plain.get(title, title)
+	if title in depth:
+		return depth[title]
+	if title in path:
+		notes.add('recursion through ' + title)
+		return 0
+	if title not in frames:
+		if title != '__indirect_call':
+			notes.add('no stack information for ' + title)
+		return 0
+	size, kind = frames[title]
+	if kind != 'static':
+		notes.add('%s has a %s sized frame' % (title, kind))
+	deepest = 0
+	for callee in calls.get(title, ()):
+		targets = indirect_targets(title) if callee == '__indirect_call' else [callee]
+		for target in targets:
+			deepest = max(deepest, worst(target, path | {title}))
+	depth[title] = size + deepest
+	return depth[title]
+
+total = 0
+for entry in ENTRY_POINTS:
+	if plain.get(entry, entry) not in frames:
+		continue
+	value = worst(entry, frozenset())
+	total += value
+	print('%-32s %6d bytes' % (entry, value))
+
+# Each interrupt runs at its own priority, so all of them can nest on top of Main.
+print('%-32s %6d bytes (+ 32 bytes exception frame per interrupt)' % ('Main + nested interrupts', total))
+for note in sorted(notes):
+	print('note: ' + note)
@@ -92,6 +92,6 @@ void UI_DrawDialogText(UI_DialogText_t Text, bool bSet)
 	}
 
 	gRedrawScreen = true;
-	VOX_Timer = 1200;
+	SCHEDULER_StartTimer(TIMER_VOX, 1200);
 }
 
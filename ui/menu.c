@@ -181,7 +181,12 @@ void UI_DrawActions(uint8_t Index)
 #else
 		"[DISABLED]  ",
 #endif
-		"Dark Mode   "
+		"Dark Mode   ",
+#ifdef ENABLE_CLOSE_CALL
+		"Close Call  ",
+#else
+		"[DISABLED]  ",
+#endif
 	};
 
 	UI_DrawSettingOptionEx(Actions[Index], 12, 0);